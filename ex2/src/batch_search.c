@@ -0,0 +1,265 @@
+#include "batch_search.h"
+#include "edit_distance.h"
+#include "utf8.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief A query of the batch, with its position in the caller's array.
+ */
+typedef struct {
+    const char *word;
+    int index;
+} batch_query;
+
+/**
+ * @brief State shared by the worker threads.
+ */
+typedef struct {
+    char **dictionary;
+    const utf8_words *decoded;   // Code point lengths and non-ASCII words of the dictionary
+    int dict_size;
+    int max_distance;
+    const batch_query *unique;   // Distinct queries
+    int nunique;
+    int *best_ids;               // Closest dictionary word of each distinct query, or -1
+    int next_tile;               // First distinct query of the next tile to search
+    pthread_mutex_t lock;        // Protects `next_tile`
+} batch_state;
+
+/**
+ * @brief State of a worker thread.
+ */
+typedef struct {
+    batch_state *state;
+    long long candidates;
+    long long cells;
+} batch_worker;
+
+/**
+ * @brief Orders queries by word, then by position.
+ *
+ * @param q1 Pointer to the first query.
+ * @param q2 Pointer to the second query.
+ * @return A negative, zero or positive value as the first query sorts before, with or after the second.
+ */
+static int compare_queries(const void *q1, const void *q2) {
+    const batch_query *a = q1;
+    const batch_query *b = q2;
+    int order = strcmp(a->word, b->word);
+    if (order != 0) return order;
+    return (a->index > b->index) - (a->index < b->index);
+}
+
+/**
+ * @brief Searches a tile of distinct queries against the whole dictionary.
+ *
+ * The queries of the tile are decoded into the context once, then the dictionary is walked
+ * block by block, and every query of the tile is compared with the block before moving to
+ * the next one. Each query keeps its closest word so far and verifies the next words
+ * against a threshold one below its distance, which keeps the first word at the smallest
+ * distance; words whose length alone is too far are skipped without a call. Pairs of ASCII
+ * words are compared byte by byte, the others on their code points.
+ *
+ * @param state Shared state.
+ * @param first First distinct query of the tile.
+ * @param last One past the last distinct query of the tile.
+ * @param distances Scratch space of `BATCH_QUERY_TILE` integers.
+ * @param context Edit distance context of the calling thread.
+ * @return The number of dictionary words compared.
+ */
+static long long search_tile(batch_state *state, int first, int last, int *distances, ed_context *context) {
+    const utf8_words *decoded = state->decoded;
+    int start[BATCH_QUERY_TILE], lengths[BATCH_QUERY_TILE], ascii[BATCH_QUERY_TILE];
+    long long compared = 0;
+
+    size_t bytes = 0;
+    for (int q = first; q < last; ++q) {
+        bytes += strlen(state->unique[q].word);
+    }
+    unsigned int *codepoints = ed_context_codepoints(context, bytes + (size_t)decoded->max_length);
+    int used = 0;
+    for (int q = first; q < last; ++q) {
+        const char *word = state->unique[q].word;
+        ascii[q - first] = utf8_is_ascii(word, strlen(word));
+        start[q - first] = used;
+        lengths[q - first] = utf8_decode(word, codepoints + used);
+        used += lengths[q - first];
+        state->best_ids[q] = -1;
+        distances[q - first] = state->max_distance + 1;
+    }
+    unsigned int *buffer = codepoints + used; // Widened ASCII dictionary words
+
+    for (int block = 0; block < state->dict_size; block += BATCH_DICT_TILE) {
+        int end = (block + BATCH_DICT_TILE < state->dict_size) ? block + BATCH_DICT_TILE : state->dict_size;
+        for (int q = first; q < last; ++q) {
+            const char *word = state->unique[q].word;
+            int length = lengths[q - first];
+            int bound = distances[q - first] - 1;
+            for (int w = block; w < end && bound >= 0; ++w) {
+                int difference = length - decoded->lengths[w];
+                if (difference > bound || -difference > bound) continue;
+                compared++;
+                int dist;
+                if (ascii[q - first] && decoded->start[w] < 0) {
+                    dist = edit_distance_bounded_ctx(context, word, state->dictionary[w], bound);
+                } else {
+                    const unsigned int *other = utf8_words_codepoints(decoded, state->dictionary, w, buffer);
+                    dist = edit_distance_codepoints_ctx(context, codepoints + start[q - first], length, other,
+                                                        decoded->lengths[w], bound);
+                }
+                if (dist <= bound) {
+                    distances[q - first] = dist;
+                    state->best_ids[q] = w;
+                    bound = dist - 1;
+                }
+            }
+        }
+    }
+    return compared;
+}
+
+/**
+ * @brief Main loop of a worker thread: takes query tiles from the shared cursor until none is left.
+ *
+ * @param arg Pointer to the `batch_worker` state.
+ * @return NULL.
+ */
+static void *batch_worker_run(void *arg) {
+    batch_worker *worker = arg;
+    batch_state *state = worker->state;
+    int distances[BATCH_QUERY_TILE];
+    ed_context *context = ed_context_create();
+
+    for (;;) {
+        pthread_mutex_lock(&state->lock);
+        int first = state->next_tile;
+        state->next_tile += BATCH_QUERY_TILE;
+        pthread_mutex_unlock(&state->lock);
+        if (first >= state->nunique) break;
+        int last = (first + BATCH_QUERY_TILE < state->nunique) ? first + BATCH_QUERY_TILE : state->nunique;
+
+        worker->candidates += search_tile(state, first, last, distances, context);
+    }
+
+    worker->cells = context->cells_computed;
+    ed_context_free(context);
+    return NULL;
+}
+
+/**
+ * @brief Finds the closest dictionary word of each word of a batch.
+ *
+ * This function sorts the queries to drop the repeated ones, measures the dictionary words
+ * and decodes the non-ASCII ones once unless the caller already did, searches the distinct queries in tiles on the worker threads, and copies each
+ * answer to every position where its query occurs.
+ *
+ * @param queries Array of pointers to the words to be corrected.
+ * @param nqueries Number of words to be corrected.
+ * @param dictionary Array of pointers to dictionary words.
+ * @param dict_size Number of words in the dictionary.
+ * @param decoded Dictionary decoded by `utf8_words_decode`, or NULL to decode it here.
+ * @param max_distance Maximum allowed edit distance.
+ * @param num_threads Number of worker threads.
+ * @param results Output array of the closest dictionary words.
+ * @param candidates Output number of dictionary words compared; may be NULL.
+ * @param cells Output number of table cells evaluated by the comparisons; may be NULL.
+ * @return The number of distinct queries searched.
+ */
+int find_closest_words(char **queries, int nqueries, char **dictionary, int dict_size,
+                       const utf8_words *decoded, int max_distance, int num_threads, char **results, long long *candidates, long long *cells) {
+    if (candidates) {
+        *candidates = 0;
+    }
+    if (cells) {
+        *cells = 0;
+    }
+    if (nqueries <= 0) {
+        return 0;
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    batch_query *sorted = malloc((size_t)nqueries * sizeof(batch_query));
+    batch_query *unique = malloc((size_t)nqueries * sizeof(batch_query));
+    int *slot = malloc((size_t)nqueries * sizeof(int));
+    int *best_ids = malloc((size_t)nqueries * sizeof(int));
+    if (!sorted || !unique || !slot || !best_ids) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    // Sort the queries so that the repeated ones are adjacent, and keep the first of each
+    for (int q = 0; q < nqueries; ++q) {
+        sorted[q].word = queries[q];
+        sorted[q].index = q;
+    }
+    qsort(sorted, (size_t)nqueries, sizeof(batch_query), compare_queries);
+    int nunique = 0;
+    for (int q = 0; q < nqueries; ++q) {
+        if (q == 0 || strcmp(sorted[q].word, sorted[q - 1].word) != 0) {
+            unique[nunique++] = sorted[q];
+        }
+        slot[sorted[q].index] = nunique - 1;
+    }
+    utf8_words *owned = decoded ? NULL : utf8_words_decode(dictionary, dict_size);
+
+    batch_state state;
+    state.dictionary = dictionary;
+    state.decoded = decoded ? decoded : owned;
+    state.dict_size = dict_size;
+    state.max_distance = max_distance;
+    state.unique = unique;
+    state.nunique = nunique;
+    state.best_ids = best_ids;
+    state.next_tile = 0;
+    pthread_mutex_init(&state.lock, NULL);
+
+    // No more threads than tiles
+    int ntiles = (nunique + BATCH_QUERY_TILE - 1) / BATCH_QUERY_TILE;
+    if (num_threads > ntiles) {
+        num_threads = ntiles;
+    }
+    pthread_t *threads = malloc((size_t)num_threads * sizeof(pthread_t));
+    batch_worker *workers = malloc((size_t)num_threads * sizeof(batch_worker));
+    if (!threads || !workers) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < num_threads; ++t) {
+        workers[t].state = &state;
+        workers[t].candidates = 0;
+        workers[t].cells = 0;
+        if (pthread_create(&threads[t], NULL, batch_worker_run, &workers[t]) != 0) {
+            perror("Error creating worker thread");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int t = 0; t < num_threads; ++t) {
+        pthread_join(threads[t], NULL);
+        if (candidates) {
+            *candidates += workers[t].candidates;
+        }
+        if (cells) {
+            *cells += workers[t].cells;
+        }
+    }
+    pthread_mutex_destroy(&state.lock);
+
+    for (int q = 0; q < nqueries; ++q) {
+        int id = best_ids[slot[q]];
+        results[q] = (id >= 0) ? dictionary[id] : NULL;
+    }
+
+    free(workers);
+    free(threads);
+    utf8_words_free(owned);
+    free(best_ids);
+    free(slot);
+    free(unique);
+    free(sorted);
+    return nunique;
+}
@@ -0,0 +1,36 @@
+#ifndef BATCH_SEARCH_H
+#define BATCH_SEARCH_H
+
+#include "utf8.h"
+
+#define BATCH_QUERY_TILE 64   // Queries searched together against each dictionary block
+#define BATCH_DICT_TILE 4096  // Dictionary words of a block, about a hundred kilobytes of text
+
+/**
+ * @brief Finds the closest dictionary word of each word of a batch.
+ *
+ * The answers are those of one `find_closest_word` call per query: the first dictionary
+ * word at the smallest distance within the threshold, distances counting the code points
+ * of UTF-8 words. Repeated queries are searched once.
+ * The work is cut into tiles of `BATCH_QUERY_TILE` distinct queries by `BATCH_DICT_TILE`
+ * dictionary words, and each tile of queries walks the dictionary block by block, so a
+ * block is brought into cache once for the whole tile instead of once per query. The query
+ * tiles are dealt to `num_threads` worker threads.
+ *
+ * @param queries Array of pointers to the words to be corrected.
+ * @param nqueries Number of words to be corrected.
+ * @param dictionary Array of pointers to dictionary words.
+ * @param dict_size Number of words in the dictionary.
+ * @param decoded Dictionary decoded by `utf8_words_decode`, or NULL to decode it here.
+ * @param max_distance Maximum allowed edit distance.
+ * @param num_threads Number of worker threads (values below 1 are treated as 1).
+ * @param results Output array of `nqueries` pointers to the closest dictionary words, NULL
+ *                where no word is within `max_distance`.
+ * @param candidates Output number of dictionary words compared; may be NULL.
+ * @param cells Output number of table cells evaluated by the comparisons; may be NULL.
+ * @return The number of distinct queries searched.
+ */
+int find_closest_words(char **queries, int nqueries, char **dictionary, int dict_size,
+                       const utf8_words *decoded, int max_distance, int num_threads, char **results, long long *candidates, long long *cells);
+
+#endif // BATCH_SEARCH_H
@@ -0,0 +1,123 @@
+#include "bloom_filter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOOM_BLOCK_BYTES (BLOOM_BLOCK_WORDS * sizeof(unsigned long long))
+
+/**
+ * @brief Scrambles a key hash, so that hashes with weak low bits spread over the filter.
+ *
+ * @param hash 64-bit hash of the key.
+ * @return The mixed hash.
+ */
+static unsigned long long mix(unsigned long long hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * @brief Creates an empty blocked Bloom filter.
+ *
+ * A classic filter reaches the rate `p` with `log2(1 / p)` hashes and `log2(1 / p) / ln 2`
+ * bits per key; both are derived from the rate without the math library.
+ *
+ * @param expected_keys Number of keys that will be added.
+ * @param false_positive_rate Target false positive rate.
+ * @param size_bytes Size of the filter in bytes, or 0 to derive it from the rate.
+ * @return Pointer to the new filter.
+ */
+bloom_filter *bloom_filter_create(size_t expected_keys, double false_positive_rate, size_t size_bytes) {
+    bloom_filter *filter = malloc(sizeof(bloom_filter));
+    if (!filter) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    int nhashes = 0;
+    for (double p = 1.0; p > false_positive_rate && nhashes < BLOOM_MAX_HASHES; p /= 2) {
+        nhashes++;
+    }
+    filter->nhashes = (nhashes > 0) ? nhashes : 1;
+
+    if (size_bytes == 0) {
+        size_t bits = expected_keys * (size_t)filter->nhashes * 1443 / 1000; // 1 / ln 2 bits per hash
+        size_bytes = bits / 8;
+    }
+    filter->nblocks = (size_bytes + BLOOM_BLOCK_BYTES - 1) / BLOOM_BLOCK_BYTES;
+    if (filter->nblocks == 0) filter->nblocks = 1;
+
+    filter->blocks = aligned_alloc(BLOOM_BLOCK_BYTES, filter->nblocks * BLOOM_BLOCK_BYTES);
+    if (!filter->blocks) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    memset(filter->blocks, 0, filter->nblocks * BLOOM_BLOCK_BYTES);
+    return filter;
+}
+
+/**
+ * @brief Adds a key to the filter.
+ *
+ * The high half of the mixed hash picks the block; the bits inside the block are the
+ * double-hashing sequence `a + i * b` modulo 512 of two fields of the low half.
+ *
+ * @param filter Pointer to the filter.
+ * @param hash 64-bit hash of the key.
+ */
+void bloom_filter_add(bloom_filter *filter, unsigned long long hash) {
+    hash = mix(hash);
+    unsigned long long *block = filter->blocks + (size_t)(((hash >> 32) * filter->nblocks) >> 32) * BLOOM_BLOCK_WORDS;
+    unsigned int a = (unsigned int)hash & 511;
+    unsigned int b = ((unsigned int)(hash >> 9) & 511) | 1;
+    for (int i = 0; i < filter->nhashes; ++i) {
+        block[a / 64] |= 1ULL << (a % 64);
+        a = (a + b) & 511;
+    }
+}
+
+/**
+ * @brief Checks whether a key may have been added to the filter.
+ *
+ * @param filter Pointer to the filter.
+ * @param hash 64-bit hash of the key.
+ * @return 0 if the key was certainly not added, 1 if it may have been.
+ */
+int bloom_filter_may_contain(const bloom_filter *filter, unsigned long long hash) {
+    hash = mix(hash);
+    const unsigned long long *block = filter->blocks + (size_t)(((hash >> 32) * filter->nblocks) >> 32) * BLOOM_BLOCK_WORDS;
+    unsigned int a = (unsigned int)hash & 511;
+    unsigned int b = ((unsigned int)(hash >> 9) & 511) | 1;
+    for (int i = 0; i < filter->nhashes; ++i) {
+        if (!(block[a / 64] & (1ULL << (a % 64)))) {
+            return 0;
+        }
+        a = (a + b) & 511;
+    }
+    return 1;
+}
+
+/**
+ * @brief Returns the memory held by the bits of the filter, in bytes.
+ *
+ * @param filter Pointer to the filter.
+ * @return The size of the filter.
+ */
+size_t bloom_filter_memory(const bloom_filter *filter) {
+    return filter->nblocks * BLOOM_BLOCK_BYTES;
+}
+
+/**
+ * @brief Frees the memory held by a filter.
+ *
+ * @param filter Pointer to the filter.
+ */
+void bloom_filter_free(bloom_filter *filter) {
+    if (!filter) return;
+    free(filter->blocks);
+    free(filter);
+}
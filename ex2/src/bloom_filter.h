@@ -0,0 +1,69 @@
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <stddef.h>
+
+#define BLOOM_BLOCK_WORDS 8     // 64-bit words in a block: one 64-byte cache line
+#define BLOOM_MAX_HASHES 16     // Largest number of bits set per key
+
+/**
+ * @brief Blocked Bloom filter over 64-bit key hashes.
+ *
+ * Every key sets all of its bits in a single cache-line block chosen by its hash, so a
+ * lookup touches one cache line whatever the number of bits per key. A negative answer is
+ * always right; a positive one is wrong with a probability slightly above that of a
+ * classic Bloom filter of the same size.
+ */
+typedef struct {
+    unsigned long long *blocks;  // `nblocks * BLOOM_BLOCK_WORDS` words, aligned to a cache line
+    size_t nblocks;
+    int nhashes;                 // Bits set per key
+} bloom_filter;
+
+/**
+ * @brief Creates an empty blocked Bloom filter.
+ *
+ * The number of bits per key is the one giving `false_positive_rate` to a classic filter.
+ * The filter is sized for `expected_keys` keys with it, unless `size_bytes` is not zero,
+ * in which case it is the size of the filter, rounded up to whole blocks.
+ *
+ * @param expected_keys Number of keys that will be added.
+ * @param false_positive_rate Target false positive rate, between 0 and 1.
+ * @param size_bytes Size of the filter in bytes, or 0 to derive it from the rate.
+ * @return Pointer to the new filter.
+ */
+bloom_filter *bloom_filter_create(size_t expected_keys, double false_positive_rate, size_t size_bytes);
+
+/**
+ * @brief Adds a key to the filter.
+ *
+ * @param filter Pointer to the filter.
+ * @param hash 64-bit hash of the key.
+ */
+void bloom_filter_add(bloom_filter *filter, unsigned long long hash);
+
+/**
+ * @brief Checks whether a key may have been added to the filter.
+ *
+ * @param filter Pointer to the filter.
+ * @param hash 64-bit hash of the key.
+ * @return 0 if the key was certainly not added, 1 if it may have been.
+ */
+int bloom_filter_may_contain(const bloom_filter *filter, unsigned long long hash);
+
+/**
+ * @brief Returns the memory held by the bits of the filter, in bytes.
+ *
+ * @param filter Pointer to the filter.
+ * @return The size of the filter.
+ */
+size_t bloom_filter_memory(const bloom_filter *filter);
+
+/**
+ * @brief Frees the memory held by a filter.
+ *
+ * @param filter Pointer to the filter.
+ */
+void bloom_filter_free(bloom_filter *filter);
+
+#endif // BLOOM_FILTER_H
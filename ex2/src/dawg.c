@@ -0,0 +1,508 @@
+#include "dawg.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Allocates a new state with no transitions.
+ *
+ * @return Pointer to the new state.
+ */
+static dawg_node *new_node(void) {
+    dawg_node *node = calloc(1, sizeof(dawg_node));
+    if (!node) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    node->offset = -1;
+    return node;
+}
+
+/**
+ * @brief Appends a transition to a state.
+ *
+ * @param node State the transition leaves from.
+ * @param label Label of the transition.
+ * @param target State the transition leads to.
+ */
+static void add_edge(dawg_node *node, unsigned char label, dawg_node *target) {
+    if (node->nedges == node->capacity) {
+        int capacity = node->capacity ? 2 * node->capacity : 2;
+        dawg_edge *temp = realloc(node->edges, (size_t)capacity * sizeof(dawg_edge));
+        if (!temp) {
+            perror("Memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+        node->edges = temp;
+        node->capacity = capacity;
+    }
+    node->edges[node->nedges].label = label;
+    node->edges[node->nedges].target = target;
+    node->nedges++;
+}
+
+/**
+ * @brief Hashes a state by its finality and its transitions.
+ *
+ * Two states with the same hash are candidates for being merged.
+ *
+ * @param node State to hash.
+ * @return The hash of the state.
+ */
+static size_t hash_node(const dawg_node *node) {
+    size_t hash = (size_t)node->final + 1;
+    for (int i = 0; i < node->nedges; ++i) {
+        hash = hash * 31 + node->edges[i].label;
+        hash = hash * 1000003 + (size_t)(uintptr_t)node->edges[i].target;
+    }
+    return hash ^ (hash >> 17);
+}
+
+/**
+ * @brief Checks whether two states recognize the same language.
+ *
+ * Since the targets of their transitions are already minimal, it is enough to compare
+ * finality, labels and targets.
+ *
+ * @param a First state.
+ * @param b Second state.
+ * @return Non-zero value if the states are equivalent, zero otherwise.
+ */
+static int equivalent(const dawg_node *a, const dawg_node *b) {
+    if (a->final != b->final || a->nedges != b->nedges) return 0;
+    for (int i = 0; i < a->nedges; ++i) {
+        if (a->edges[i].label != b->edges[i].label || a->edges[i].target != b->edges[i].target) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Inserts a state in the registry without checking for equivalent states.
+ *
+ * @param automaton Automaton being built.
+ * @param node State to register.
+ */
+static void registry_insert(dawg *automaton, dawg_node *node) {
+    size_t mask = (size_t)automaton->registry_capacity - 1;
+    size_t slot = hash_node(node) & mask;
+    while (automaton->registry[slot]) slot = (slot + 1) & mask;
+    automaton->registry[slot] = node;
+}
+
+/**
+ * @brief Returns the registered state equivalent to `node`, registering `node` if there is none.
+ *
+ * @param automaton Automaton being built.
+ * @param node State to look up.
+ * @return The equivalent registered state, or `node` itself.
+ */
+static dawg_node *registry_find_or_add(dawg *automaton, dawg_node *node) {
+    size_t mask = (size_t)automaton->registry_capacity - 1;
+    size_t slot = hash_node(node) & mask;
+    while (automaton->registry[slot]) {
+        if (equivalent(automaton->registry[slot], node)) {
+            return automaton->registry[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    automaton->registry[slot] = node;
+    automaton->node_count++;
+    automaton->edge_count += node->nedges;
+
+    // Keep the load factor below one half
+    if (2 * (automaton->node_count + 1) > automaton->registry_capacity) {
+        dawg_node **old = automaton->registry;
+        int old_capacity = automaton->registry_capacity;
+        automaton->registry_capacity *= 2;
+        automaton->registry = calloc((size_t)automaton->registry_capacity, sizeof(dawg_node *));
+        if (!automaton->registry) {
+            perror("Memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < old_capacity; ++i) {
+            if (old[i]) registry_insert(automaton, old[i]);
+        }
+        free(old);
+    }
+    return node;
+}
+
+/**
+ * @brief Minimizes the states along the last transitions leaving `node`.
+ *
+ * These states belong to the previous word only and cannot change any more: each of them
+ * is replaced by an equivalent registered state, or registered itself.
+ *
+ * @param automaton Automaton being built.
+ * @param node State whose last child is minimized.
+ */
+static void replace_or_register(dawg *automaton, dawg_node *node) {
+    dawg_edge *last = &node->edges[node->nedges - 1];
+    dawg_node *child = last->target;
+
+    if (child->nedges > 0) {
+        replace_or_register(automaton, child);
+    }
+
+    dawg_node *equivalent_node = registry_find_or_add(automaton, child);
+    if (equivalent_node != child) {
+        last->target = equivalent_node;
+        free(child->edges);
+        free(child);
+    }
+}
+
+/**
+ * @brief Compares two words by their bytes, for sorting the input.
+ *
+ * @param w1 Pointer to the first word pointer.
+ * @param w2 Pointer to the second word pointer.
+ * @return A negative, zero or positive value as the first word sorts before, with or after the second.
+ */
+static int compare_words(const void *w1, const void *w2) {
+    return strcmp(*(char *const *)w1, *(char *const *)w2);
+}
+
+/**
+ * @brief Builds the minimal automaton of a list of words.
+ *
+ * This function sorts a copy of the word list and adds the words in order. For each word,
+ * the states of the previous word beyond the common prefix are minimized before the new
+ * suffix is appended; the remaining path is minimized at the end.
+ *
+ * @param words Array of pointers to the words.
+ * @param count Number of words.
+ * @return Pointer to the new automaton.
+ */
+dawg *dawg_build(char **words, int count) {
+    dawg *automaton = calloc(1, sizeof(dawg));
+    char **sorted = malloc((size_t)(count + 1) * sizeof(char *));
+    if (!automaton || !sorted) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(sorted, words, (size_t)count * sizeof(char *));
+    qsort(sorted, (size_t)count, sizeof(char *), compare_words);
+
+    automaton->root = new_node();
+    automaton->node_count = 1;
+    automaton->registry_capacity = 1024;
+    automaton->registry = calloc((size_t)automaton->registry_capacity, sizeof(dawg_node *));
+    if (!automaton->registry) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    const char *previous = NULL;
+    for (int w = 0; w < count; ++w) {
+        const char *word = sorted[w];
+        if (previous && strcmp(previous, word) == 0) {
+            continue; // Duplicate word
+        }
+
+        // Follow the common prefix with the previous word, which is the path of the last transitions
+        dawg_node *node = automaton->root;
+        int prefix = 0;
+        if (previous) {
+            while (word[prefix] && word[prefix] == previous[prefix]) {
+                node = node->edges[node->nedges - 1].target;
+                prefix++;
+            }
+        }
+
+        if (node->nedges > 0) {
+            replace_or_register(automaton, node);
+        }
+
+        // Append the rest of the word as a chain of new states
+        for (const char *c = word + prefix; *c; ++c) {
+            dawg_node *next = new_node();
+            add_edge(node, (unsigned char)*c, next);
+            node = next;
+        }
+        node->final = 1;
+
+        int length = (int)strlen(word);
+        if (length > automaton->max_length) automaton->max_length = length;
+        automaton->word_count++;
+        previous = word;
+    }
+
+    if (automaton->root->nedges > 0) {
+        replace_or_register(automaton, automaton->root);
+    }
+    automaton->edge_count += automaton->root->nedges;
+
+    free(sorted);
+    return automaton;
+}
+
+/**
+ * @brief Checks whether a word is recognized by the automaton.
+ *
+ * This function follows the transitions labelled with the characters of the word, looking
+ * each one up by binary search among the sorted transitions of the current state.
+ *
+ * @param automaton Pointer to the automaton.
+ * @param word Word to look up.
+ * @return Non-zero value if the word is in the dictionary, zero otherwise.
+ */
+int dawg_contains(const dawg *automaton, const char *word) {
+    const dawg_node *node = automaton->root;
+    for (const char *c = word; *c; ++c) {
+        unsigned char label = (unsigned char)*c;
+        int lo = 0, hi = node->nedges - 1;
+        const dawg_node *next = NULL;
+        while (lo <= hi) {
+            int mid = (lo + hi) / 2;
+            if (node->edges[mid].label == label) {
+                next = node->edges[mid].target;
+                break;
+            } else if (node->edges[mid].label < label) {
+                lo = mid + 1;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        if (!next) return 0;
+        node = next;
+    }
+    return node->final;
+}
+
+/**
+ * @brief Frees the memory held by an automaton.
+ *
+ * Every state other than the root is in the registry exactly once, so the states are
+ * released by walking the registry rather than the shared transitions.
+ *
+ * @param automaton Pointer to the automaton.
+ */
+void dawg_free(dawg *automaton) {
+    if (!automaton) return;
+    for (int i = 0; i < automaton->registry_capacity; ++i) {
+        if (automaton->registry[i]) {
+            free(automaton->registry[i]->edges);
+            free(automaton->registry[i]);
+        }
+    }
+    free(automaton->registry);
+    free(automaton->root->edges);
+    free(automaton->root);
+    free(automaton);
+}
+
+/**
+ * @brief Assigns the position of the first transition of every state reachable from `node`.
+ *
+ * @param node State to lay out.
+ * @param next Next free position in the transition arrays.
+ */
+static void assign_offsets(dawg_node *node, int *next) {
+    if (node->offset >= 0 || node->nedges == 0) {
+        return; // Already laid out, or identified by the sentinel position
+    }
+    node->offset = *next;
+    *next += node->nedges;
+    for (int i = 0; i < node->nedges; ++i) {
+        assign_offsets(node->edges[i].target, next);
+    }
+}
+
+/**
+ * @brief Writes the transitions of every state reachable from `node` into the compact arrays.
+ *
+ * @param compact Compact automaton being filled.
+ * @param node State whose transitions are written.
+ * @param written Flags of the positions already written, so that shared states are written once.
+ */
+static void write_edges(dawg_compact *compact, const dawg_node *node, char *written) {
+    if (node->nedges == 0 || written[node->offset]) {
+        return;
+    }
+    written[node->offset] = 1;
+    for (int i = 0; i < node->nedges; ++i) {
+        const dawg_node *target = node->edges[i].target;
+        unsigned int word = (unsigned int)(target->nedges > 0 ? target->offset : compact->nedges);
+        if (target->final) word |= DAWG_FINAL_BIT;
+        if (i == node->nedges - 1) word |= DAWG_LAST_BIT;
+        compact->labels[node->offset + i] = node->edges[i].label;
+        compact->targets[node->offset + i] = word;
+        write_edges(compact, target, written);
+    }
+}
+
+/**
+ * @brief Converts an automaton into the compact layout.
+ *
+ * This function numbers the transitions in depth-first order from the root, then copies
+ * the labels and the targets, translated to positions, into the two flat arrays.
+ *
+ * @param automaton Pointer to the automaton.
+ * @return Pointer to the new compact automaton.
+ */
+dawg_compact *dawg_compact_build(dawg *automaton) {
+    dawg_compact *compact = calloc(1, sizeof(dawg_compact));
+    if (!compact) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    int next = 0;
+    assign_offsets(automaton->root, &next);
+    if (next > (int)DAWG_TARGET_MASK) {
+        fprintf(stderr, "Dictionary automaton too large for the compact layout\n");
+        exit(EXIT_FAILURE);
+    }
+
+    compact->nedges = next;
+    compact->labels = malloc((size_t)next + 1);
+    compact->targets = malloc(((size_t)next + 1) * sizeof(unsigned int));
+    char *written = calloc((size_t)next + 1, 1);
+    if (!compact->labels || !compact->targets || !written) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    write_edges(compact, automaton->root, written);
+    free(written);
+
+    compact->root = (unsigned int)(automaton->root->nedges > 0 ? automaton->root->offset : next);
+    compact->root_final = automaton->root->final;
+    compact->word_count = automaton->word_count;
+    compact->max_length = automaton->max_length;
+    return compact;
+}
+
+/**
+ * @brief Builds the compact minimal automaton of a list of words.
+ *
+ * @param words Array of pointers to the words.
+ * @param count Number of words.
+ * @return Pointer to the new compact automaton.
+ */
+dawg_compact *dawg_compact_from_words(char **words, int count) {
+    dawg *automaton = dawg_build(words, count);
+    dawg_compact *compact = dawg_compact_build(automaton);
+    dawg_free(automaton);
+    return compact;
+}
+
+/**
+ * @brief Checks whether a word is recognized by the compact automaton.
+ *
+ * The transitions of a state are scanned in order until the label is found or passed.
+ *
+ * @param automaton Pointer to the compact automaton.
+ * @param word Word to look up.
+ * @return Non-zero value if the word is in the dictionary, zero otherwise.
+ */
+int dawg_compact_contains(const dawg_compact *automaton, const char *word) {
+    if (!*word) {
+        return automaton->root_final;
+    }
+
+    unsigned int state = automaton->root;
+    for (const char *c = word; *c; ++c) {
+        unsigned char label = (unsigned char)*c;
+        if (state == (unsigned int)automaton->nedges) {
+            return 0; // No transitions left
+        }
+
+        unsigned int i = state;
+        while (automaton->labels[i] < label && !(automaton->targets[i] & DAWG_LAST_BIT)) {
+            i++;
+        }
+        if (automaton->labels[i] != label) {
+            return 0;
+        }
+        if (c[1] == '\0') {
+            return (automaton->targets[i] & DAWG_FINAL_BIT) != 0;
+        }
+        state = automaton->targets[i] & DAWG_TARGET_MASK;
+    }
+    return 0;
+}
+
+/**
+ * @brief Visits the words spelled by the paths leaving `state`.
+ *
+ * @param automaton Pointer to the compact automaton.
+ * @param state State being visited.
+ * @param buffer Word spelled by the path leading to `state`.
+ * @param depth Length of that word.
+ * @param visit Function called with each word.
+ * @param arg Argument passed to `visit`.
+ * @param count Number of words visited so far.
+ */
+static void iterate_state(const dawg_compact *automaton, unsigned int state, char *buffer, int depth,
+                          void (*visit)(const char *word, void *arg), void *arg, int *count) {
+    if (state == (unsigned int)automaton->nedges) {
+        return;
+    }
+    for (unsigned int i = state; ; ++i) {
+        buffer[depth] = (char)automaton->labels[i];
+        if (automaton->targets[i] & DAWG_FINAL_BIT) {
+            buffer[depth + 1] = '\0';
+            visit(buffer, arg);
+            (*count)++;
+        }
+        iterate_state(automaton, automaton->targets[i] & DAWG_TARGET_MASK, buffer, depth + 1, visit, arg, count);
+        if (automaton->targets[i] & DAWG_LAST_BIT) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Calls `visit` on every word of the compact automaton, in byte order.
+ *
+ * @param automaton Pointer to the compact automaton.
+ * @param visit Function called with each word and `arg`.
+ * @param arg Argument passed to `visit`.
+ * @return The number of words visited.
+ */
+int dawg_compact_iterate(const dawg_compact *automaton, void (*visit)(const char *word, void *arg), void *arg) {
+    char *buffer = malloc((size_t)automaton->max_length + 2);
+    if (!buffer) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    int count = 0;
+    if (automaton->root_final) {
+        buffer[0] = '\0';
+        visit(buffer, arg);
+        count++;
+    }
+    iterate_state(automaton, automaton->root, buffer, 0, visit, arg, &count);
+
+    free(buffer);
+    return count;
+}
+
+/**
+ * @brief Returns the number of bytes used by the compact automaton.
+ *
+ * @param automaton Pointer to the compact automaton.
+ * @return The size of the structure and of its transition arrays.
+ */
+size_t dawg_compact_memory(const dawg_compact *automaton) {
+    return sizeof(dawg_compact) + (size_t)automaton->nedges * (sizeof(unsigned char) + sizeof(unsigned int));
+}
+
+/**
+ * @brief Frees the memory held by a compact automaton.
+ *
+ * @param automaton Pointer to the compact automaton.
+ */
+void dawg_compact_free(dawg_compact *automaton) {
+    if (!automaton) return;
+    free(automaton->labels);
+    free(automaton->targets);
+    free(automaton);
+}
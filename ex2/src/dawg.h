@@ -0,0 +1,155 @@
+#ifndef DAWG_H
+#define DAWG_H
+
+#include <stddef.h>
+
+#define DAWG_FINAL_BIT 0x80000000u   // The target of the transition is a final state
+#define DAWG_LAST_BIT 0x40000000u    // The transition is the last one of its source state
+#define DAWG_TARGET_MASK 0x3fffffffu // Bits holding the target of the transition
+
+typedef struct dawg_node dawg_node;
+
+/**
+ * @brief A transition of the dictionary automaton.
+ */
+typedef struct {
+    unsigned char label;
+    dawg_node *target;
+} dawg_edge;
+
+/**
+ * @brief A state of the dictionary automaton.
+ *
+ * The outgoing transitions are kept sorted by label.
+ */
+struct dawg_node {
+    dawg_edge *edges;
+    int nedges;
+    int capacity;
+    int final;
+    int offset; // Position of the first transition in the compact layout, -1 until assigned
+};
+
+/**
+ * @brief Minimal deterministic acyclic automaton (DAWG) recognizing the words of a dictionary.
+ *
+ * Equivalent suffixes are shared between words, so the automaton has far fewer states
+ * than a trie of the same dictionary.
+ */
+typedef struct {
+    dawg_node *root;
+    int node_count;         // Number of states
+    int edge_count;         // Number of transitions
+    int word_count;         // Number of distinct words
+    int max_length;         // Length of the longest word
+    dawg_node **registry;   // Hash table of the states other than the root
+    int registry_capacity;
+} dawg;
+
+/**
+ * @brief Minimal dictionary automaton stored as two flat arrays of transitions.
+ *
+ * The transitions leaving a state are stored contiguously, sorted by label, and a state
+ * is identified by the position of its first transition; states without transitions are
+ * identified by `nedges`. Each transition takes five bytes: the label, and a 32-bit word
+ * holding the target state together with `DAWG_FINAL_BIT` and `DAWG_LAST_BIT`. No
+ * pointers are stored, so the dictionary can be queried and enumerated in place.
+ */
+typedef struct {
+    unsigned char *labels;  // Label of each transition
+    unsigned int *targets;  // Target state and flags of each transition
+    int nedges;             // Number of transitions
+    unsigned int root;      // Initial state
+    int root_final;         // Whether the empty word is in the dictionary
+    int word_count;         // Number of distinct words
+    int max_length;         // Length of the longest word
+} dawg_compact;
+
+/**
+ * @brief Builds the minimal automaton of a list of words.
+ *
+ * The words are sorted first, then added one at a time with the incremental algorithm by
+ * Daciuk et al.: when a word is added, the states left behind by the previous word can no
+ * longer change, and each of them is either merged with an equivalent registered state or
+ * registered itself. Duplicate words are ignored.
+ *
+ * @param words Array of pointers to the words.
+ * @param count Number of words.
+ * @return Pointer to the new automaton.
+ */
+dawg *dawg_build(char **words, int count);
+
+/**
+ * @brief Checks whether a word is recognized by the automaton.
+ *
+ * @param automaton Pointer to the automaton.
+ * @param word Word to look up.
+ * @return Non-zero value if the word is in the dictionary, zero otherwise.
+ */
+int dawg_contains(const dawg *automaton, const char *word);
+
+/**
+ * @brief Frees the memory held by an automaton.
+ *
+ * @param automaton Pointer to the automaton.
+ */
+void dawg_free(dawg *automaton);
+
+/**
+ * @brief Converts an automaton into the compact layout.
+ *
+ * The states are laid out in depth-first order from the root, so that a state is usually
+ * stored close to the states it leads to. The original automaton keeps recognizing the
+ * same words and must still be freed with `dawg_free`.
+ *
+ * @param automaton Pointer to the automaton.
+ * @return Pointer to the new compact automaton.
+ */
+dawg_compact *dawg_compact_build(dawg *automaton);
+
+/**
+ * @brief Builds the compact minimal automaton of a list of words.
+ *
+ * The intermediate pointer-based automaton is released before returning.
+ *
+ * @param words Array of pointers to the words.
+ * @param count Number of words.
+ * @return Pointer to the new compact automaton.
+ */
+dawg_compact *dawg_compact_from_words(char **words, int count);
+
+/**
+ * @brief Checks whether a word is recognized by the compact automaton.
+ *
+ * @param automaton Pointer to the compact automaton.
+ * @param word Word to look up.
+ * @return Non-zero value if the word is in the dictionary, zero otherwise.
+ */
+int dawg_compact_contains(const dawg_compact *automaton, const char *word);
+
+/**
+ * @brief Calls `visit` on every word of the compact automaton, in byte order.
+ *
+ * @param automaton Pointer to the compact automaton.
+ * @param visit Function called with each word and `arg`; the word is only valid during the call.
+ * @param arg Argument passed to `visit`.
+ * @return The number of words visited.
+ */
+int dawg_compact_iterate(const dawg_compact *automaton, void (*visit)(const char *word, void *arg), void *arg);
+
+/**
+ * @brief Returns the number of bytes used by the compact automaton.
+ *
+ * @param automaton Pointer to the compact automaton.
+ * @return The size of the structure and of its transition arrays.
+ */
+size_t dawg_compact_memory(const dawg_compact *automaton);
+
+/**
+ * @brief Frees the memory held by a compact automaton.
+ *
+ * @param automaton Pointer to the compact automaton.
+ */
+void dawg_compact_free(dawg_compact *automaton);
+
+#endif // DAWG_H
@@ -0,0 +1,253 @@
+#include "ed_cursor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief State of the cursor-driven dictionary traversal.
+ */
+typedef struct {
+    ed_cursor *cursor;
+    const dawg_compact *dictionary;
+    char *buffer;       // Word spelled by the current path
+    size_t size;
+    char *result;
+    int best_distance;
+} cursor_search;
+
+/**
+ * @brief Creates a cursor on a word, with nothing typed yet.
+ *
+ * This function builds the match mask of every character of the word and pushes the
+ * all-ones vector of the empty typed string.
+ *
+ * @param word Fixed word.
+ * @return Pointer to the new cursor.
+ */
+ed_cursor *ed_cursor_create(const char *word) {
+    ed_cursor *cursor = malloc(sizeof(ed_cursor));
+    if (!cursor) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    cursor->length = (int)strlen(word);
+    cursor->words = cursor->length / 64 + 1;
+
+    int distinct = 0;
+    for (int c = 0; c < 256; ++c) {
+        cursor->mask_index[c] = -1;
+    }
+    for (int j = 0; j < cursor->length; ++j) {
+        unsigned char c = (unsigned char)word[j];
+        if (cursor->mask_index[c] < 0) {
+            cursor->mask_index[c] = distinct++;
+        }
+    }
+
+    cursor->masks = calloc((size_t)(distinct + 1) * (size_t)cursor->words, sizeof(unsigned long long));
+    cursor->capacity = 16;
+    cursor->stack = malloc((size_t)cursor->capacity * (size_t)cursor->words * sizeof(unsigned long long));
+    if (!cursor->masks || !cursor->stack) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int j = 0; j < cursor->length; ++j) {
+        unsigned long long *mask = cursor->masks + (size_t)cursor->mask_index[(unsigned char)word[j]] * (size_t)cursor->words;
+        mask[j / 64] |= 1ULL << (j % 64);
+    }
+
+    memset(cursor->stack, 0xff, (size_t)cursor->words * sizeof(unsigned long long)); // Empty LCS everywhere
+    cursor->depth = 0;
+    return cursor;
+}
+
+/**
+ * @brief Appends a character to the typed string.
+ *
+ * With `V` the current vector and `M` the match mask of `c`, the new vector is
+ * `(V + (V & M)) | (V & ~M)`; the addition carries across the 64-bit words.
+ *
+ * @param cursor Pointer to the cursor.
+ * @param c Character typed.
+ */
+void ed_cursor_push(ed_cursor *cursor, char c) {
+    if (cursor->depth + 1 == cursor->capacity) {
+        cursor->capacity *= 2;
+        unsigned long long *temp = realloc(cursor->stack, (size_t)cursor->capacity * (size_t)cursor->words * sizeof(unsigned long long));
+        if (!temp) {
+            perror("Memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+        cursor->stack = temp;
+    }
+
+    const unsigned long long *v = cursor->stack + (size_t)cursor->depth * (size_t)cursor->words;
+    unsigned long long *next = cursor->stack + (size_t)(cursor->depth + 1) * (size_t)cursor->words;
+    int index = cursor->mask_index[(unsigned char)c];
+
+    if (index < 0) {
+        memcpy(next, v, (size_t)cursor->words * sizeof(unsigned long long)); // No match: the LCS does not change
+    } else {
+        const unsigned long long *mask = cursor->masks + (size_t)index * (size_t)cursor->words;
+        unsigned long long carry = 0;
+        for (int w = 0; w < cursor->words; ++w) {
+            unsigned long long u = v[w] & mask[w];
+            unsigned long long sum = v[w] + u;
+            unsigned long long carry_out = (sum < v[w]);
+            sum += carry;
+            carry_out |= (sum < carry);
+            carry = carry_out;
+            next[w] = sum | (v[w] & ~mask[w]);
+        }
+    }
+    cursor->depth++;
+}
+
+/**
+ * @brief Removes the last character of the typed string (backspace).
+ *
+ * @param cursor Pointer to the cursor.
+ * @return 1 if a character was removed, 0 if nothing was typed.
+ */
+int ed_cursor_pop(ed_cursor *cursor) {
+    if (cursor->depth == 0) {
+        return 0;
+    }
+    cursor->depth--;
+    return 1;
+}
+
+/**
+ * @brief Returns the edit distance between the typed string and the word.
+ *
+ * The LCS is the number of zero bits among the first `length` bits of the current vector.
+ *
+ * @param cursor Pointer to the cursor.
+ * @return The edit distance.
+ */
+int ed_cursor_distance(const ed_cursor *cursor) {
+    const unsigned long long *v = cursor->stack + (size_t)cursor->depth * (size_t)cursor->words;
+    int lcs = 0;
+    for (int w = 0; w < cursor->words; ++w) {
+        int bits = (cursor->length - 64 * w < 64) ? cursor->length - 64 * w : 64;
+        if (bits <= 0) break;
+        unsigned long long valid = (bits == 64) ? ~0ULL : (1ULL << bits) - 1;
+        lcs += bits - __builtin_popcountll(v[w] & valid);
+    }
+    return cursor->depth + cursor->length - 2 * lcs;
+}
+
+/**
+ * @brief Returns the edit distance between the typed string and the closest prefix of the word.
+ *
+ * The distance to the prefix of length `j` is `depth + j - 2 * LCS_j`, where `LCS_j` counts
+ * the zero bits below bit `j`; the minimum is taken over every `j`.
+ *
+ * @param cursor Pointer to the cursor.
+ * @return The smallest edit distance to a prefix of the word.
+ */
+int ed_cursor_prefix_distance(const ed_cursor *cursor) {
+    const unsigned long long *v = cursor->stack + (size_t)cursor->depth * (size_t)cursor->words;
+    int best = cursor->depth; // Empty prefix
+    int lcs = 0;
+    for (int j = 1; j <= cursor->length; ++j) {
+        if (!((v[(j - 1) / 64] >> ((j - 1) % 64)) & 1ULL)) {
+            lcs++;
+        }
+        int distance = cursor->depth + j - 2 * lcs;
+        if (distance < best) best = distance;
+    }
+    return best;
+}
+
+/**
+ * @brief Frees the memory held by a cursor.
+ *
+ * @param cursor Pointer to the cursor.
+ */
+void ed_cursor_free(ed_cursor *cursor) {
+    if (!cursor) return;
+    free(cursor->masks);
+    free(cursor->stack);
+    free(cursor);
+}
+
+/**
+ * @brief Visits the dictionary automaton from `state`, pushing each label on the cursor.
+ *
+ * @param search Search state.
+ * @param state Current state of the dictionary automaton.
+ */
+static void search_state(cursor_search *search, unsigned int state) {
+    const dawg_compact *dictionary = search->dictionary;
+    int depth = search->cursor->depth;
+    if (state == (unsigned int)dictionary->nedges || (size_t)depth + 1 >= search->size) {
+        return; // No transitions, or longer words would not fit in the result buffer
+    }
+
+    for (unsigned int i = state; search->best_distance > 0; ++i) {
+        unsigned int target = dictionary->targets[i];
+        ed_cursor_push(search->cursor, (char)dictionary->labels[i]);
+
+        // No word below this transition can be closer than its prefix distance
+        if (ed_cursor_prefix_distance(search->cursor) < search->best_distance) {
+            search->buffer[depth] = (char)dictionary->labels[i];
+            if (target & DAWG_FINAL_BIT) {
+                int distance = ed_cursor_distance(search->cursor);
+                if (distance < search->best_distance) {
+                    search->best_distance = distance;
+                    memcpy(search->result, search->buffer, (size_t)depth + 1);
+                    search->result[depth + 1] = '\0';
+                }
+            }
+            search_state(search, target & DAWG_TARGET_MASK);
+        }
+
+        ed_cursor_pop(search->cursor);
+        if (target & DAWG_LAST_BIT) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Finds the dictionary word closest to a word with a cursor-driven dictionary traversal.
+ *
+ * @param word Word to be corrected.
+ * @param dictionary Pointer to the dictionary automaton, in the compact layout.
+ * @param max_distance Maximum allowed edit distance.
+ * @param result Buffer receiving the closest word.
+ * @param size Size of the buffer.
+ * @return The distance of the closest word, or -1 if no word is within `max_distance`.
+ */
+int ed_cursor_find_closest(const char *word, const dawg_compact *dictionary, int max_distance, char *result, size_t size) {
+    if (max_distance < 0) {
+        return -1;
+    }
+
+    char *buffer = malloc(size);
+    if (!buffer) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    cursor_search search;
+    search.cursor = ed_cursor_create(word);
+    search.dictionary = dictionary;
+    search.buffer = buffer;
+    search.size = size;
+    search.result = result;
+    search.best_distance = max_distance + 1;
+
+    if (dictionary->root_final && ed_cursor_distance(search.cursor) < search.best_distance) {
+        search.best_distance = ed_cursor_distance(search.cursor);
+        result[0] = '\0';
+    }
+    search_state(&search, dictionary->root);
+
+    ed_cursor_free(search.cursor);
+    free(buffer);
+    return (search.best_distance <= max_distance) ? search.best_distance : -1;
+}
@@ -0,0 +1,96 @@
+#ifndef ED_CURSOR_H
+#define ED_CURSOR_H
+
+#include <stddef.h>
+#include "dawg.h"
+
+/**
+ * @brief Incremental edit distance between a fixed word and a string typed one character at a time.
+ *
+ * For the insert/delete cost model the distance is `|a| + |b| - 2 * LCS(a, b)`, and the
+ * longest common subsequence of the typed string with every prefix of the word is encoded
+ * in one bit vector of `|word|` bits (bit `j` is zero where the LCS grows at word position
+ * `j`). Appending a character updates the vector with a few word-wide operations, in
+ * O(|word| / 64) time; the vectors of all the typed prefixes are kept on a stack, so a
+ * backspace only pops the last one.
+ */
+typedef struct {
+    int length;                    // Length of the fixed word
+    int words;                     // 64-bit words in each bit vector
+    int mask_index[256];           // Slot of the match mask of each character, -1 if it does not occur
+    unsigned long long *masks;     // Match masks of the characters occurring in the word
+    unsigned long long *stack;     // Bit vector of every typed prefix, the current one last
+    int depth;                     // Number of characters typed
+    int capacity;                  // Number of bit vectors the stack can hold
+} ed_cursor;
+
+/**
+ * @brief Creates a cursor on a word, with nothing typed yet.
+ *
+ * @param word Fixed word; it is not referenced after the call.
+ * @return Pointer to the new cursor.
+ */
+ed_cursor *ed_cursor_create(const char *word);
+
+/**
+ * @brief Appends a character to the typed string.
+ *
+ * @param cursor Pointer to the cursor.
+ * @param c Character typed.
+ */
+void ed_cursor_push(ed_cursor *cursor, char c);
+
+/**
+ * @brief Removes the last character of the typed string (backspace).
+ *
+ * @param cursor Pointer to the cursor.
+ * @return 1 if a character was removed, 0 if nothing was typed.
+ */
+int ed_cursor_pop(ed_cursor *cursor);
+
+/**
+ * @brief Returns the edit distance between the typed string and the word.
+ *
+ * @param cursor Pointer to the cursor.
+ * @return The edit distance.
+ */
+int ed_cursor_distance(const ed_cursor *cursor);
+
+/**
+ * @brief Returns the edit distance between the typed string and the closest prefix of the word.
+ *
+ * This is the distance an autocomplete front end ranks completions by. It is also a lower
+ * bound on the distance between the word and any string starting with the typed one, which
+ * makes it the pruning test of a dictionary search. It takes O(|word|) time.
+ *
+ * @param cursor Pointer to the cursor.
+ * @return The smallest edit distance to a prefix of the word.
+ */
+int ed_cursor_prefix_distance(const ed_cursor *cursor);
+
+/**
+ * @brief Frees the memory held by a cursor.
+ *
+ * @param cursor Pointer to the cursor.
+ */
+void ed_cursor_free(ed_cursor *cursor);
+
+/**
+ * @brief Finds the dictionary word closest to a word with a cursor-driven dictionary traversal.
+ *
+ * The dictionary automaton is visited depth first; every transition pushes its label on a
+ * cursor built on `word` and returning from it pops the label, and a branch is abandoned
+ * as soon as the prefix distance shows it cannot beat the best word found so far. Unlike
+ * the Levenshtein automaton, any threshold is supported. Among equally close words the
+ * first in byte order is returned.
+ *
+ * @param word Word to be corrected.
+ * @param dictionary Pointer to the dictionary automaton, in the compact layout.
+ * @param max_distance Maximum allowed edit distance.
+ * @param result Buffer receiving the closest word.
+ * @param size Size of the buffer.
+ * @return The distance of the closest word, or -1 if no word is within `max_distance`.
+ */
+int ed_cursor_find_closest(const char *word, const dawg_compact *dictionary, int max_distance, char *result, size_t size);
+
+#endif // ED_CURSOR_H
@@ -1,7 +1,13 @@
 #include "edit_distance.h"
+#include "utf8.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #define MAXLEN 1000 // Maximum length of strings considered
+#define LAZY_MAX_CELLS (1 << 20) // Largest band evaluated by the lazy engine of `edit_distance`
+#define DIAGONAL_MIN_LENGTH 64 // Shortest strings for which diagonal transition is tried
+#define DIAGONAL_RATIO 8 // Diagonal transition is tried up to this fraction of the shorter length
 
 /**
  * @brief Returns the minimum of two integers.
@@ -15,56 +21,487 @@ static int min(int a, int b) {
 }
 
 /**
- * @brief Recursively calculates the edit distance between two strings using memoization.
+ * @brief Two rows of scratch cells kept on the stack, in each of the widths of the kernels.
  * 
- * This function calculates the edit distance between two strings `s1` and `s2` by recursively
- * computing the cost of insertions, deletions, and substitutions, and storing the results in a
- * memoization table to avoid redundant computations.
+ * The kernels access their cells through a pointer to their own cell type, so they are
+ * handed the member of that type, never an `int` array read as narrower cells.
+ */
+typedef union {
+    int cells_32[2 * (MAXLEN + 2)];
+    unsigned short cells_16[2 * (MAXLEN + 2)];
+    unsigned char cells_8[2 * (MAXLEN + 2)];
+} stack_rows;
+
+/**
+ * @brief Returns the member of the stack rows whose cells are the narrowest able to hold a value.
+ * 
+ * @param rows Stack rows.
+ * @param max_value Largest value the cells must hold.
+ * @return The cells of one, two or four bytes.
+ */
+static void *stack_cells(stack_rows *rows, int max_value) {
+    if (max_value <= UCHAR_MAX) {
+        return rows->cells_8;
+    }
+    if (max_value <= USHRT_MAX) {
+        return rows->cells_16;
+    }
+    return rows->cells_32;
+}
+
+/**
+ * @brief Defines a kernel filling the band of the table within `max_distance` of the diagonal.
+ * 
+ * The kernels differ in the type of the cells of their two rows and in the type of the
+ * characters: bytes, or code points decoded from UTF-8. Cells saturate at
+ * `max_distance + 1`, so a type is wide enough as soon as it can hold that value.
+ * 
+ * Each kernel takes the two strings and their lengths, the threshold, scratch space for
+ * `2 * (len2 + 2)` cells and a counter of the cells evaluated, and returns the edit
+ * distance between the two strings, or `max_distance + 1` if it is larger.
+ */
+#define DEFINE_BAND_KERNEL(name, cell_t, char_t)                                               \
+static int name(const char_t *s1, const char_t *s2, int len1, int len2, int max_distance,     \
+                void *scratch, long long *computed) {                                          \
+    int limit = max_distance + 1;                                                              \
+    cell_t *prev = scratch;                                                                    \
+    cell_t *curr = prev + len2 + 2;                                                            \
+                                                                                               \
+    for (int j = 0; j <= len2 + 1; ++j) {                                                      \
+        prev[j] = (cell_t)((j <= max_distance) ? j : limit);                                   \
+    }                                                                                          \
+                                                                                               \
+    int i;                                                                                     \
+    for (i = 1; i <= len1; ++i) {                                                              \
+        int lo = (i - max_distance > 1) ? i - max_distance : 1;                                \
+        int hi = (i + max_distance < len2) ? i + max_distance : len2;                          \
+        char_t c = s1[i - 1];                                                                  \
+                                                                                               \
+        curr[lo - 1] = (cell_t)((lo == 1 && i <= max_distance) ? i : limit);                   \
+        int row_min = curr[lo - 1];                                                            \
+        for (int j = lo; j <= hi; ++j) {                                                       \
+            int value;                                                                         \
+            if (c == s2[j - 1]) {                                                              \
+                value = prev[j - 1]; /* Characters match, no operation needed */               \
+            } else {                                                                           \
+                value = 1 + min(prev[j],      /* Delete */                                     \
+                                curr[j - 1]); /* Insert */                                     \
+            }                                                                                  \
+            curr[j] = (cell_t)((value < limit) ? value : limit);                               \
+            row_min = min(row_min, curr[j]);                                                   \
+        }                                                                                      \
+        curr[hi + 1] = (cell_t)limit; /* Read as the cell above by the next row */             \
+        *computed += hi - lo + 1;                                                              \
+                                                                                               \
+        if (row_min >= limit) {                                                                \
+            break; /* Every path through this row is already too expensive */                  \
+        }                                                                                      \
+                                                                                               \
+        cell_t *temp = prev;                                                                   \
+        prev = curr;                                                                           \
+        curr = temp;                                                                           \
+    }                                                                                          \
+    return (i > len1) ? prev[len2] : limit;                                                    \
+}
+
+DEFINE_BAND_KERNEL(edit_distance_band_8, unsigned char, char)
+DEFINE_BAND_KERNEL(edit_distance_band_16, unsigned short, char)
+DEFINE_BAND_KERNEL(edit_distance_band_32, int, char)
+DEFINE_BAND_KERNEL(codepoint_band_8, unsigned char, unsigned int)
+DEFINE_BAND_KERNEL(codepoint_band_16, unsigned short, unsigned int)
+DEFINE_BAND_KERNEL(codepoint_band_32, int, unsigned int)
+
+/**
+ * @brief Defines a kernel filling the whole dynamic programming table, keeping two rows.
+ * 
+ * The kernels only differ in the type of the cells of their two rows, which must hold
+ * `len1 + len2`, the largest possible distance; no cell needs to be clamped.
+ * 
+ * Each kernel takes the two strings and their lengths and scratch space for `2 * (len2 + 1)`
+ * cells, and returns the edit distance between the two strings.
+ */
+#define DEFINE_ROWS_KERNEL(name, cell_t)                                                       \
+static int name(const char *s1, const char *s2, int len1, int len2, void *scratch) {           \
+    cell_t *prev = scratch;                                                                    \
+    cell_t *curr = prev + len2 + 1;                                                            \
+                                                                                               \
+    for (int j = 0; j <= len2; ++j) {                                                          \
+        prev[j] = (cell_t)j; /* If s1 is empty, all characters of s2 need to be inserted */    \
+    }                                                                                          \
+    for (int i = 1; i <= len1; ++i) {                                                          \
+        char c = s1[i - 1];                                                                    \
+        curr[0] = (cell_t)i; /* If s2 is empty, all characters of s1 need to be deleted */     \
+        for (int j = 1; j <= len2; ++j) {                                                      \
+            if (c == s2[j - 1]) {                                                              \
+                curr[j] = prev[j - 1]; /* Characters match, no operation needed */             \
+            } else {                                                                           \
+                curr[j] = (cell_t)(1 + min(prev[j],        /* Delete */                        \
+                                           curr[j - 1]));  /* Insert */                        \
+            }                                                                                  \
+        }                                                                                      \
+        cell_t *temp = prev;                                                                   \
+        prev = curr;                                                                           \
+        curr = temp;                                                                           \
+    }                                                                                          \
+    return prev[len2];                                                                         \
+}
+
+DEFINE_ROWS_KERNEL(edit_distance_rows_8, unsigned char)
+DEFINE_ROWS_KERNEL(edit_distance_rows_16, unsigned short)
+DEFINE_ROWS_KERNEL(edit_distance_rows_32, int)
+
+/**
+ * @brief Fills the band of the dynamic programming table within `max_distance` of the diagonal.
+ * 
+ * The narrowest cells able to hold `max_distance + 1` are used: one byte for the thresholds
+ * of a spell checker, four only for distances beyond 65534, so that the two rows take as
+ * little cache as possible.
  * 
  * @param s1 First string.
  * @param s2 Second string.
  * @param len1 Length of the first string.
  * @param len2 Length of the second string.
- * @param memo 2D array used for memoization.
- * @return The edit distance between the two strings.
+ * @param max_distance Largest distance the caller is interested in.
+ * @param rows Scratch space of `2 * (len2 + 2)` cells of the width chosen, from the heap or
+ *             from `stack_cells`.
+ * @param computed Counter of the cells evaluated.
+ * @return The edit distance between the two strings, or `max_distance + 1` if it is larger.
  */
-static int edit_distance_recursive(const char *s1, const char *s2, int len1, int len2, int memo[MAXLEN + 1][MAXLEN + 1]) {
-    if (memo[len1][len2] != -1) return memo[len1][len2];
+static int edit_distance_band(const char *s1, const char *s2, int len1, int len2, int max_distance, void *rows,
+                              long long *computed) {
+    if (max_distance < UCHAR_MAX) {
+        return edit_distance_band_8(s1, s2, len1, len2, max_distance, rows, computed);
+    }
+    if (max_distance < USHRT_MAX) {
+        return edit_distance_band_16(s1, s2, len1, len2, max_distance, rows, computed);
+    }
+    return edit_distance_band_32(s1, s2, len1, len2, max_distance, rows, computed);
+}
 
-    if (len1 == 0) return len2;
-    if (len2 == 0) return len1;
+/**
+ * @brief Returns the length of the longest common prefix of two strings, up to a limit.
+ * 
+ * The strings are compared eight bytes at a time, and byte by byte only within the first
+ * word that differs.
+ * 
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @param limit Number of characters available in both strings.
+ * @return The length of the common prefix.
+ */
+static int common_prefix(const char *s1, const char *s2, int limit) {
+    int n = 0;
+    while (n + 8 <= limit) {
+        unsigned long long w1, w2;
+        memcpy(&w1, s1 + n, sizeof(w1));
+        memcpy(&w2, s2 + n, sizeof(w2));
+        if (w1 != w2) break;
+        n += 8;
+    }
+    while (n < limit && s1[n] == s2[n]) n++;
+    return n;
+}
 
-    if (s1[0] == s2[0]) {
-        memo[len1][len2] = edit_distance_recursive(s1 + 1, s2 + 1, len1 - 1, len2 - 1, memo);
-    } else {
-        int insert = 1 + edit_distance_recursive(s1, s2 + 1, len1, len2 - 1, memo); // Insert
-        int delete = 1 + edit_distance_recursive(s1 + 1, s2, len1 - 1, len2, memo); // Delete
-        memo[len1][len2] = min(insert, delete);
+/**
+ * @brief Returns the length of the longest common suffix of two strings, up to a limit.
+ * 
+ * @param end1 One past the last character of the first string.
+ * @param end2 One past the last character of the second string.
+ * @param limit Number of characters available in both strings.
+ * @return The length of the common suffix.
+ */
+static int common_suffix(const char *end1, const char *end2, int limit) {
+    int n = 0;
+    while (n + 8 <= limit) {
+        unsigned long long w1, w2;
+        memcpy(&w1, end1 - n - 8, sizeof(w1));
+        memcpy(&w2, end2 - n - 8, sizeof(w2));
+        if (w1 != w2) break;
+        n += 8;
+    }
+    while (n < limit && end1[-n - 1] == end2[-n - 1]) n++;
+    return n;
+}
+
+/**
+ * @brief Computes the edit distance by diagonal transition, giving up past a threshold.
+ * 
+ * For each number of operations `d` the furthest point reached on every diagonal
+ * `k = i - j` is kept in `v`: it is one step away from the furthest point of a neighbouring
+ * diagonal after `d - 1` operations, followed by the run of matching characters, which is
+ * measured by `common_prefix`. The first `d` at which the corner is reached is the distance,
+ * so the cost is `O((len1 + len2) * d)` whatever the lengths.
+ * 
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @param len1 Length of the first string.
+ * @param len2 Length of the second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @param v Scratch space of `2 * max_distance + 3` integers.
+ * @param computed Counter of the diagonal points evaluated.
+ * @return The edit distance between the two strings, or `max_distance + 1` if it is larger.
+ */
+static int diagonal_distance(const char *s1, const char *s2, int len1, int len2, int max_distance, int *v,
+                             long long *computed) {
+    int *furthest = v + max_distance + 1; // Indexed by diagonal, from -max_distance - 1
+
+    for (int d = 0; d <= max_distance; ++d) {
+        for (int k = -d; k <= d; k += 2) {
+            if (k < -len2 || k > len1) {
+                furthest[k] = -1; // The diagonal does not cross the table
+                continue;
+            }
+
+            int i = -1;
+            if (d == 0) {
+                i = 0;
+            } else {
+                if (k > -d && furthest[k - 1] >= 0 && furthest[k - 1] < len1) {
+                    i = furthest[k - 1] + 1; // Delete a character of s1
+                }
+                if (k < d && furthest[k + 1] >= 0 && furthest[k + 1] - k <= len2 && furthest[k + 1] > i) {
+                    i = furthest[k + 1]; // Insert a character of s2
+                }
+            }
+            if (i < 0) {
+                furthest[k] = -1;
+                continue;
+            }
+
+            int j = i - k;
+            int remaining = (len1 - i < len2 - j) ? len1 - i : len2 - j;
+            i += common_prefix(s1 + i, s2 + j, remaining);
+            furthest[k] = i;
+            (*computed)++;
+            if (i == len1 && i - k == len2) {
+                return d;
+            }
+        }
+    }
+    return max_distance + 1;
+}
+
+/**
+ * @brief Strips the common prefix and suffix of two strings, which do not change their distance.
+ * 
+ * @param s1 Pointer to the first string, advanced past the common prefix.
+ * @param s2 Pointer to the second string, advanced past the common prefix.
+ * @param len1 Pointer to the length of the first string, reduced accordingly.
+ * @param len2 Pointer to the length of the second string, reduced accordingly.
+ */
+static void trim_common(const char **s1, const char **s2, int *len1, int *len2) {
+    int prefix = common_prefix(*s1, *s2, min(*len1, *len2));
+    *s1 += prefix;
+    *s2 += prefix;
+    *len1 -= prefix;
+    *len2 -= prefix;
+    int suffix = common_suffix(*s1 + *len1, *s2 + *len2, min(*len1, *len2));
+    *len1 -= suffix;
+    *len2 -= suffix;
+}
+
+/**
+ * @brief Predicts from the lengths whether diagonal transition is worth trying, and how far.
+ * 
+ * Diagonal transition wins when the distance is small compared to the lengths. The distance
+ * is at least the length difference, so strings whose difference is already a sizeable
+ * fraction of their length go straight to the full table; the others are given a budget
+ * small enough that a failed attempt costs a fraction of the table.
+ * 
+ * @param len1 Length of the first string, without the common prefix and suffix.
+ * @param len2 Length of the second string, without the common prefix and suffix.
+ * @return The threshold to try diagonal transition with, or 0 if it should not be tried.
+ */
+static int diagonal_budget(int len1, int len2) {
+    int shorter = min(len1, len2);
+    int difference = (len1 > len2) ? len1 - len2 : len2 - len1;
+    int budget = shorter / DIAGONAL_RATIO;
+    if (shorter < DIAGONAL_MIN_LENGTH || difference > budget) {
+        return 0;
     }
+    return budget;
+}
 
-    return memo[len1][len2];
+/**
+ * @brief Makes sure a scratch array holds at least `count` integers.
+ * 
+ * @param cells Pointer to the array, reallocated if needed.
+ * @param capacity Pointer to the number of integers the array can hold.
+ * @param count Number of integers needed.
+ */
+static void grow_cells(int **cells, size_t *capacity, size_t count) {
+    if (count <= *capacity) return;
+    size_t new_capacity = *capacity ? *capacity : 1024;
+    while (new_capacity < count) new_capacity *= 2;
+    int *temp = realloc(*cells, new_capacity * sizeof(int));
+    if (!temp) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    *cells = temp;
+    *capacity = new_capacity;
+}
+
+/**
+ * @brief Returns the value of a cell for the lazy evaluation, or -1 if it is not known yet.
+ * 
+ * Cell `(a, b)` is the edit distance between the suffixes of length `a` and `b`. Cells more
+ * than `k` diagonals away from the start cannot lie on a path within the bound, and values
+ * are clamped to `k + 1`.
+ * 
+ * @param memo Band of memoized cells, `2 * k + 1` per row.
+ * @param len1 Length of the first string.
+ * @param len2 Length of the second string.
+ * @param k Bound of the evaluation.
+ * @param a Length of the suffix of the first string.
+ * @param b Length of the suffix of the second string.
+ * @return The value of the cell, or -1.
+ */
+static int lazy_value(const int *memo, int len1, int len2, int k, int a, int b) {
+    if (a == 0) return min(b, k + 1); // The rest of s2 needs to be inserted
+    if (b == 0) return min(a, k + 1); // The rest of s1 needs to be deleted
+    int i = len1 - a;
+    int j = len2 - b;
+    if (j - i > k || i - j > k) return k + 1;
+    return memo[(size_t)i * (size_t)(2 * k + 1) + (size_t)(j - i + k)];
+}
+
+/**
+ * @brief Evaluates the edit distance under a bound, lazily and without recursion.
+ * 
+ * This is the memoized recursion on suffixes, run with an explicit stack of pending cells:
+ * a cell is computed once the cells it depends on are known, and when the first characters
+ * of its suffixes match it depends on the diagonal cell only, so similar strings leave most
+ * of the band unvisited.
+ * 
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @param len1 Length of the first string, at least 1.
+ * @param len2 Length of the second string, at least 1.
+ * @param k Bound of the evaluation.
+ * @param memo Band of `(len1 + 1) * (2 * k + 1)` cells.
+ * @param stack Stack of `4 * (len1 + len2 + 1)` integers.
+ * @param computed Counter of the cells computed.
+ * @return The edit distance between the two strings, or `k + 1` if it is larger.
+ */
+static int lazy_band_distance(const char *s1, const char *s2, int len1, int len2, int k, int *memo, int *stack,
+                              long long *computed) {
+    size_t width = (size_t)(2 * k + 1);
+    size_t band = ((size_t)len1 + 1) * width;
+    for (size_t c = 0; c < band; ++c) {
+        memo[c] = -1;
+    }
+
+    int top = 0;
+    stack[0] = len1;
+    stack[1] = len2;
+    while (top >= 0) {
+        int a = stack[2 * top];
+        int b = stack[2 * top + 1];
+        int i = len1 - a;
+        int j = len2 - b;
+        int *cell = &memo[(size_t)i * width + (size_t)(j - i + k)];
+        if (*cell >= 0) {
+            top--; // Reached twice before being computed
+            continue;
+        }
+
+        if (s1[i] == s2[j]) {
+            int diagonal = lazy_value(memo, len1, len2, k, a - 1, b - 1); // Characters match, no operation needed
+            if (diagonal < 0) {
+                top++;
+                stack[2 * top] = a - 1;
+                stack[2 * top + 1] = b - 1;
+                continue;
+            }
+            *cell = diagonal;
+        } else {
+            int insert = lazy_value(memo, len1, len2, k, a, b - 1);
+            int delete = lazy_value(memo, len1, len2, k, a - 1, b);
+            if (insert < 0 || delete < 0) {
+                if (insert < 0) {
+                    top++;
+                    stack[2 * top] = a;
+                    stack[2 * top + 1] = b - 1;
+                }
+                if (delete < 0) {
+                    top++;
+                    stack[2 * top] = a - 1;
+                    stack[2 * top + 1] = b;
+                }
+                continue;
+            }
+            *cell = min(1 + min(insert, delete), k + 1);
+        }
+        (*computed)++;
+        top--;
+    }
+    return memo[(size_t)k];
+}
+
+/**
+ * @brief Computes the edit distance with the lazy engine, doubling the bound until it holds.
+ * 
+ * The bound starts from the length difference, which the distance cannot be below. Each
+ * round of the lazy engine needs a band of `(len1 + 1) * (2 * k + 1)` cells; once that
+ * exceeds `LAZY_MAX_CELLS` the following rounds fill the band with two rows instead, so the
+ * memory stays bounded whatever the strings, and the time stays proportional to the bound.
+ * 
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @param len1 Length of the first string.
+ * @param len2 Length of the second string.
+ * @param cells Pointer to the scratch array, grown as needed.
+ * @param capacity Pointer to the number of integers the scratch array can hold.
+ * @param computed Counter of the cells computed.
+ * @return The edit distance between the two strings.
+ */
+static int lazy_distance(const char *s1, const char *s2, int len1, int len2, int **cells, size_t *capacity,
+                         long long *computed) {
+    if (len1 == 0 || len2 == 0) {
+        return len1 + len2;
+    }
+
+    int k = (len1 > len2) ? len1 - len2 : len2 - len1;
+    if (k == 0) k = 1;
+    for (;;) {
+        size_t band = ((size_t)len1 + 1) * (size_t)(2 * k + 1);
+        int distance;
+        if (band <= LAZY_MAX_CELLS) {
+            grow_cells(cells, capacity, band + 4 * ((size_t)len1 + (size_t)len2 + 1));
+            distance = lazy_band_distance(s1, s2, len1, len2, k, *cells, *cells + band, computed);
+        } else {
+            grow_cells(cells, capacity, 2 * ((size_t)len2 + 2));
+            distance = edit_distance_band(s1, s2, len1, len2, k, *cells, computed);
+        }
+        if (distance <= k) {
+            return distance;
+        }
+        k = min(2 * k, len1 + len2);
+    }
 }
 
 /**
  * @brief Computes the edit distance between two strings using recursive approach with memoization.
  * 
- * This function initializes the memoization table and calls the recursive function to calculate
- * the edit distance between `s1` and `s2`.
+ * The recursion is run by `lazy_distance` with an explicit stack, so long strings cannot
+ * overflow the call stack.
  * 
  * @param s1 First string.
  * @param s2 Second string.
  * @return The edit distance between the two strings.
  */
 int edit_distance(const char *s1, const char *s2) {
-    int len1 = strlen(s1);
-    int len2 = strlen(s2);
+    int len1 = (int)strlen(s1);
+    int len2 = (int)strlen(s2);
+    int *cells = NULL;
+    size_t capacity = 0;
+    long long computed = 0;
 
-    int memo[MAXLEN + 1][MAXLEN + 1];
-    for (int i = 0; i <= len1; ++i)
-        for (int j = 0; j <= len2; ++j)
-            memo[i][j] = -1;
+    int distance = lazy_distance(s1, s2, len1, len2, &cells, &capacity, &computed);
+    free(cells);
 
-    return edit_distance_recursive(s1, s2, len1, len2, memo);
+    return distance;
 }
 
 /**
@@ -72,32 +509,398 @@ int edit_distance(const char *s1, const char *s2) {
  * 
  * This function calculates the edit distance between `s1` and `s2` by filling a dynamic
  * programming table based on the previous computations to determine the minimum number of
- * operations (insertions and deletions) required.
+ * operations (insertions and deletions) required. The common prefix and suffix are stripped
+ * first; when the rest is long and of similar lengths, diagonal transition is tried with a
+ * budget, and the table is filled only if the distance turns out to exceed it. The table is
+ * filled row by row keeping only two rows, whose cells are as narrow as `len1 + len2`, the
+ * largest possible distance, allows; the rows live on the stack for strings up to `MAXLEN`
+ * characters and on the heap otherwise.
  * 
  * @param s1 First string.
  * @param s2 Second string.
  * @return The edit distance between the two strings.
  */
 int edit_distance_dyn(const char *s1, const char *s2) {
-    int len1 = strlen(s1);
-    int len2 = strlen(s2);
-
-    int memo[MAXLEN + 1][MAXLEN + 1];
-
-    for (int i = 0; i <= len1; ++i) {
-        for (int j = 0; j <= len2; ++j) {
-            if (i == 0) {
-                memo[i][j] = j; // If s1 is empty, all characters of s2 need to be inserted
-            } else if (j == 0) {
-                memo[i][j] = i; // If s2 is empty, all characters of s1 need to be deleted
-            } else if (s1[i - 1] == s2[j - 1]) {
-                memo[i][j] = memo[i - 1][j - 1]; // Characters match, no operation needed
-            } else {
-                memo[i][j] = 1 + min(memo[i - 1][j],  // Delete
-                                    memo[i][j - 1]); // Insert
-            }
+    int len1 = (int)strlen(s1);
+    int len2 = (int)strlen(s2);
+    long long computed = 0;
+
+    trim_common(&s1, &s2, &len1, &len2);
+    if (len1 == 0 || len2 == 0) {
+        return len1 + len2;
+    }
+
+    stack_rows stack;
+    void *heap = NULL;
+    if (len2 > MAXLEN) {
+        heap = malloc(2 * (size_t)(len2 + 1) * sizeof(int));
+        if (!heap) {
+            perror("Memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // The budget is at most len2 / DIAGONAL_RATIO, so the diagonals fit in the rows
+    int budget = diagonal_budget(len1, len2);
+    int *diagonals = heap ? heap : stack.cells_32;
+    int result = (budget > 0) ? diagonal_distance(s1, s2, len1, len2, budget, diagonals, &computed) : budget + 1;
+    if (result > budget) {
+        // No path costs more than deleting s1 and inserting s2: that bounds the cell width
+        void *rows = heap ? heap : stack_cells(&stack, len1 + len2);
+        if (len1 + len2 <= UCHAR_MAX) {
+            result = edit_distance_rows_8(s1, s2, len1, len2, rows);
+        } else if (len1 + len2 <= USHRT_MAX) {
+            result = edit_distance_rows_16(s1, s2, len1, len2, rows);
+        } else {
+            result = edit_distance_rows_32(s1, s2, len1, len2, rows);
         }
     }
 
-    return memo[len1][len2];
+    free(heap);
+    return result;
+}
+
+/**
+ * @brief Computes the edit distance between two strings, giving up past a threshold.
+ * 
+ * This function evaluates only the cells `(i, j)` with `|i - j| <= max_distance`, since any
+ * path through the other cells already costs more than the threshold. Two rows are kept;
+ * they live on the stack for strings up to `MAXLEN` characters and on the heap otherwise.
+ * 
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance between the two strings, or `max_distance + 1` if it is larger.
+ */
+int edit_distance_bounded(const char *s1, const char *s2, int max_distance) {
+    int len1 = (int)strlen(s1);
+    int len2 = (int)strlen(s2);
+    long long cells = 0;
+
+    if (len1 - len2 > max_distance || len2 - len1 > max_distance) {
+        return max_distance + 1; // The length difference alone exceeds the threshold
+    }
+
+    stack_rows stack;
+    void *heap = NULL;
+    if (len2 > MAXLEN) {
+        heap = malloc(2 * (size_t)(len2 + 2) * sizeof(int));
+        if (!heap) {
+            perror("Memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    void *rows = heap ? heap : stack_cells(&stack, max_distance + 1);
+    int result = edit_distance_band(s1, s2, len1, len2, max_distance, rows, &cells);
+
+    free(heap);
+    return result;
+}
+
+/**
+ * @brief Computes the edit distance by diagonal transition, giving up past a threshold.
+ * 
+ * After the common prefix and suffix are stripped, the furthest point of each diagonal is
+ * advanced one operation at a time; the diagonals live on the stack for thresholds up to
+ * `MAXLEN` and on the heap otherwise.
+ * 
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance between the two strings, or `max_distance + 1` if it is larger.
+ */
+int edit_distance_diagonal(const char *s1, const char *s2, int max_distance) {
+    int len1 = (int)strlen(s1);
+    int len2 = (int)strlen(s2);
+    long long computed = 0;
+
+    trim_common(&s1, &s2, &len1, &len2);
+    if (len1 - len2 > max_distance || len2 - len1 > max_distance) {
+        return max_distance + 1; // The length difference alone exceeds the threshold
+    }
+    if (len1 == 0 || len2 == 0) {
+        return len1 + len2;
+    }
+
+    int stack_diagonals[2 * MAXLEN + 3];
+    int *diagonals = stack_diagonals;
+    if (max_distance > MAXLEN) {
+        diagonals = malloc((2 * (size_t)max_distance + 3) * sizeof(int));
+        if (!diagonals) {
+            perror("Memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    int result = diagonal_distance(s1, s2, len1, len2, max_distance, diagonals, &computed);
+
+    if (diagonals != stack_diagonals) {
+        free(diagonals);
+    }
+    return result;
+}
+
+/**
+ * @brief Makes sure the context holds at least `count` scratch cells.
+ * 
+ * @param context Pointer to the context.
+ * @param count Number of cells needed.
+ */
+static void reserve_cells(ed_context *context, size_t count) {
+    grow_cells(&context->cells, &context->cells_capacity, count);
+}
+
+/**
+ * @brief Makes sure the context holds at least `count` scratch bit vector words.
+ * 
+ * @param context Pointer to the context.
+ * @param count Number of 64-bit words needed.
+ */
+static void reserve_bits(ed_context *context, size_t count) {
+    if (count <= context->bits_capacity) return;
+    size_t capacity = context->bits_capacity ? context->bits_capacity : 64;
+    while (capacity < count) capacity *= 2;
+    unsigned long long *temp = realloc(context->bits, capacity * sizeof(unsigned long long));
+    if (!temp) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    context->bits = temp;
+    context->bits_capacity = capacity;
+}
+
+/**
+ * @brief Creates an edit distance context with empty statistics.
+ * 
+ * The scratch buffers are allocated by the first kernel calls that need them.
+ * 
+ * @return Pointer to the new context.
+ */
+ed_context *ed_context_create(void) {
+    ed_context *context = calloc(1, sizeof(ed_context));
+    if (!context) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < 256; ++c) {
+        context->mask_index[c] = -1;
+    }
+    return context;
+}
+
+/**
+ * @brief Frees the memory held by an edit distance context.
+ * 
+ * @param context Pointer to the context.
+ */
+void ed_context_free(ed_context *context) {
+    if (!context) return;
+    free(context->cells);
+    free(context->bits);
+    free(context->codepoints);
+    free(context);
+}
+
+/**
+ * @brief Computes the edit distance between two strings recursively, memoizing in a context.
+ * 
+ * This is `edit_distance` with the band and the stack of the lazy engine taken from the
+ * context.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @return The edit distance between the two strings.
+ */
+int edit_distance_ctx(ed_context *context, const char *s1, const char *s2) {
+    int len1 = (int)strlen(s1);
+    int len2 = (int)strlen(s2);
+
+    context->calls++;
+    return lazy_distance(s1, s2, len1, len2, &context->cells, &context->cells_capacity, &context->cells_computed);
+}
+
+/**
+ * @brief Computes the edit distance between two strings with a bit-parallel kernel.
+ * 
+ * Bit `j` of the vector `V` is zero where the LCS of the processed prefix of `s1` with the
+ * prefixes of `s2` grows at position `j`; with `M` the match mask of the next character of
+ * `s1`, the vector becomes `(V + (V & M)) | (V & ~M)`, the addition carrying across words.
+ * As in `edit_distance_dyn`, near-identical strings are handled by diagonal transition.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @return The edit distance between the two strings.
+ */
+int edit_distance_dyn_ctx(ed_context *context, const char *s1, const char *s2) {
+    int len1 = (int)strlen(s1);
+    int len2 = (int)strlen(s2);
+    int distinct = 0;
+
+    context->calls++;
+    trim_common(&s1, &s2, &len1, &len2);
+    if (len1 == 0 || len2 == 0) {
+        return len1 + len2;
+    }
+
+    int budget = diagonal_budget(len1, len2);
+    if (budget > 0) {
+        reserve_cells(context, 2 * (size_t)budget + 3);
+        int distance = diagonal_distance(s1, s2, len1, len2, budget, context->cells, &context->cells_computed);
+        if (distance <= budget) {
+            return distance;
+        }
+    }
+
+    size_t words = (size_t)len2 / 64 + 1;
+    context->cells_computed += (long long)len1 * len2;
+
+    for (int j = 0; j < len2; ++j) {
+        unsigned char c = (unsigned char)s2[j];
+        if (context->mask_index[c] < 0) {
+            context->mask_index[c] = distinct++;
+        }
+    }
+
+    // Slots 0 .. distinct - 1 hold the masks, the last one the vector
+    reserve_bits(context, ((size_t)distinct + 1) * words);
+    unsigned long long *v = context->bits + (size_t)distinct * words;
+    memset(context->bits, 0, (size_t)distinct * words * sizeof(unsigned long long));
+    memset(v, 0xff, words * sizeof(unsigned long long)); // Empty LCS everywhere
+    for (int j = 0; j < len2; ++j) {
+        context->bits[(size_t)context->mask_index[(unsigned char)s2[j]] * words + (size_t)j / 64] |= 1ULL << (j % 64);
+    }
+
+    for (int i = 0; i < len1; ++i) {
+        int index = context->mask_index[(unsigned char)s1[i]];
+        if (index < 0) continue; // The character does not occur in s2
+        const unsigned long long *mask = context->bits + (size_t)index * words;
+        unsigned long long carry = 0;
+        for (size_t w = 0; w < words; ++w) {
+            unsigned long long u = v[w] & mask[w];
+            unsigned long long sum = v[w] + u;
+            unsigned long long carry_out = (sum < v[w]);
+            sum += carry;
+            carry_out |= (sum < carry);
+            carry = carry_out;
+            v[w] = sum | (v[w] & ~mask[w]);
+        }
+    }
+
+    int lcs = 0;
+    for (int j = 0; j < len2; ++j) {
+        if (!((v[j / 64] >> (j % 64)) & 1ULL)) lcs++;
+        context->mask_index[(unsigned char)s2[j]] = -1;
+    }
+    return len1 + len2 - 2 * lcs;
+}
+
+/**
+ * @brief Computes the edit distance between two strings, giving up past a threshold, in a context.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance between the two strings, or `max_distance + 1` if it is larger.
+ */
+int edit_distance_bounded_ctx(ed_context *context, const char *s1, const char *s2, int max_distance) {
+    int len1 = (int)strlen(s1);
+    int len2 = (int)strlen(s2);
+
+    context->calls++;
+    if (len1 - len2 > max_distance || len2 - len1 > max_distance) {
+        context->cutoffs++;
+        return max_distance + 1; // The length difference alone exceeds the threshold
+    }
+
+    reserve_cells(context, 2 * ((size_t)len2 + 2));
+    int result = edit_distance_band(s1, s2, len1, len2, max_distance, context->cells, &context->cells_computed);
+    if (result > max_distance) {
+        context->cutoffs++;
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the code point buffer of a context, holding at least `count` code points.
+ * 
+ * @param context Pointer to the context.
+ * @param count Number of code points needed.
+ * @return Pointer to the buffer; it stays valid until the next call.
+ */
+unsigned int *ed_context_codepoints(ed_context *context, size_t count) {
+    if (count > context->codepoints_capacity) {
+        size_t capacity = context->codepoints_capacity ? context->codepoints_capacity : 256;
+        while (capacity < count) capacity *= 2;
+        unsigned int *temp = realloc(context->codepoints, capacity * sizeof(unsigned int));
+        if (!temp) {
+            perror("Memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+        context->codepoints = temp;
+        context->codepoints_capacity = capacity;
+    }
+    return context->codepoints;
+}
+
+/**
+ * @brief Computes the edit distance between two code point strings, giving up past a threshold.
+ * 
+ * This is `edit_distance_bounded_ctx` on 32-bit characters: the same band is filled, with
+ * the same narrow cells.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 First string.
+ * @param len1 Length of the first string.
+ * @param s2 Second string.
+ * @param len2 Length of the second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance between the two strings, or `max_distance + 1` if it is larger.
+ */
+int edit_distance_codepoints_ctx(ed_context *context, const unsigned int *s1, int len1, const unsigned int *s2,
+                                 int len2, int max_distance) {
+    context->calls++;
+    if (len1 - len2 > max_distance || len2 - len1 > max_distance) {
+        context->cutoffs++;
+        return max_distance + 1; // The length difference alone exceeds the threshold
+    }
+
+    reserve_cells(context, 2 * ((size_t)len2 + 2));
+    int result;
+    if (max_distance < UCHAR_MAX) {
+        result = codepoint_band_8(s1, s2, len1, len2, max_distance, context->cells, &context->cells_computed);
+    } else if (max_distance < USHRT_MAX) {
+        result = codepoint_band_16(s1, s2, len1, len2, max_distance, context->cells, &context->cells_computed);
+    } else {
+        result = codepoint_band_32(s1, s2, len1, len2, max_distance, context->cells, &context->cells_computed);
+    }
+    if (result > max_distance) {
+        context->cutoffs++;
+    }
+    return result;
+}
+
+/**
+ * @brief Computes the edit distance between two UTF-8 strings, giving up past a threshold.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance in code points, or `max_distance + 1` if it is larger.
+ */
+int edit_distance_utf8_ctx(ed_context *context, const char *s1, const char *s2, int max_distance) {
+    size_t bytes1 = strlen(s1);
+    size_t bytes2 = strlen(s2);
+    if (utf8_is_ascii(s1, bytes1) && utf8_is_ascii(s2, bytes2)) {
+        return edit_distance_bounded_ctx(context, s1, s2, max_distance);
+    }
+
+    unsigned int *codepoints = ed_context_codepoints(context, bytes1 + bytes2);
+    int len1 = utf8_decode(s1, codepoints);
+    int len2 = utf8_decode(s2, codepoints + len1);
+    return edit_distance_codepoints_ctx(context, codepoints, len1, codepoints + len1, len2, max_distance);
 }
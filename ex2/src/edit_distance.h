@@ -1,11 +1,36 @@
 #ifndef EDIT_DISTANCE_H
 #define EDIT_DISTANCE_H
 
+#include <stddef.h>
+
+/**
+ * @brief Scratch memory and statistics reused by the edit distance kernels.
+ * 
+ * A context is created once per thread and passed to the `_ctx` variants of the kernels.
+ * Its buffers only grow, so after the first calls no kernel allocates memory, and each call
+ * initializes only the cells it is going to read. A context must not be shared by threads.
+ */
+typedef struct {
+    int *cells;                  // Scratch cells: rows of the table or the memoization table
+    size_t cells_capacity;
+    unsigned long long *bits;    // Scratch bit vectors: match masks and the LCS vector
+    size_t bits_capacity;
+    int mask_index[256];         // Slot of each character in `bits`, -1 between calls
+    unsigned int *codepoints;    // Scratch code points of decoded UTF-8 strings
+    size_t codepoints_capacity;
+    long long calls;             // Number of kernel calls
+    long long cells_computed;    // Number of table cells evaluated, by the bit-parallel kernel too
+    long long cutoffs;           // Number of bounded calls that gave up past the threshold
+} ed_context;
+
 /**
  * @brief Computes the edit distance between two strings using a recursive approach with memoization.
  * 
- * This function initializes the memoization table and calls the recursive function to calculate
- * the edit distance between the two strings `s1` and `s2`.
+ * The recursion on suffixes is evaluated lazily with an explicit stack, memoizing only the
+ * cells within a bound of the diagonal; the bound starts from the length difference and is
+ * doubled until the distance fits in it. Similar strings visit few cells, and strings of
+ * any length are accepted: when the band would exceed a fixed number of cells it is filled
+ * keeping two rows only.
  * 
  * @param s1 Pointer to the first string.
  * @param s2 Pointer to the second string.
@@ -18,7 +43,9 @@ int edit_distance(const char *s1, const char *s2);
  * 
  * This function calculates the edit distance between `s1` and `s2` by filling a dynamic
  * programming table based on previous computations to determine the minimum number of
- * operations (insertions and deletions) required.
+ * operations (insertions and deletions) required. Only two rows are kept, with cells of 8,
+ * 16 or 32 bits depending on the lengths of the strings. The common prefix and suffix are
+ * skipped, and long near-identical strings are handed to `edit_distance_diagonal` first.
  * 
  * @param s1 Pointer to the first string.
  * @param s2 Pointer to the second string.
@@ -26,4 +53,141 @@ int edit_distance(const char *s1, const char *s2);
  */
 int edit_distance_dyn(const char *s1, const char *s2);
 
+/**
+ * @brief Computes the edit distance between two strings, giving up past a threshold.
+ * 
+ * This function fills only the band of the dynamic programming table made of the cells
+ * within `max_distance` of the diagonal, keeping two rows of it, and stops as soon as a
+ * whole row exceeds the threshold. Strings are not limited in length. Cells saturate at
+ * `max_distance + 1` and are one byte wide for thresholds below 255.
+ * 
+ * @param s1 Pointer to the first string.
+ * @param s2 Pointer to the second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance between the two strings if it is at most `max_distance`,
+ *         `max_distance + 1` otherwise.
+ */
+int edit_distance_bounded(const char *s1, const char *s2, int max_distance);
+
+/**
+ * @brief Computes the edit distance between two strings by diagonal transition.
+ * 
+ * For each number of operations `d`, this function keeps the furthest point reached on
+ * every diagonal of the table and extends it along the run of matching characters, which
+ * is compared eight bytes at a time. It costs `O((len1 + len2) * d)`, so it beats the table
+ * by far on near-identical strings; `edit_distance_dyn` tries it by itself on long strings
+ * of similar lengths.
+ * 
+ * @param s1 Pointer to the first string.
+ * @param s2 Pointer to the second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance between the two strings if it is at most `max_distance`,
+ *         `max_distance + 1` otherwise.
+ */
+int edit_distance_diagonal(const char *s1, const char *s2, int max_distance);
+
+/**
+ * @brief Creates an edit distance context with empty statistics.
+ * 
+ * @return Pointer to the new context.
+ */
+ed_context *ed_context_create(void);
+
+/**
+ * @brief Frees the memory held by an edit distance context.
+ * 
+ * @param context Pointer to the context.
+ */
+void ed_context_free(ed_context *context);
+
+/**
+ * @brief Computes the edit distance between two strings recursively, memoizing in a context.
+ * 
+ * This is `edit_distance` with the band and the stack of the evaluation taken from the
+ * context.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 Pointer to the first string.
+ * @param s2 Pointer to the second string.
+ * @return The edit distance between the two strings.
+ */
+int edit_distance_ctx(ed_context *context, const char *s1, const char *s2);
+
+/**
+ * @brief Computes the edit distance between two strings with a bit-parallel kernel.
+ * 
+ * With insertions and deletions only, the distance is `len1 + len2 - 2 * LCS`, and a row of
+ * the LCS table is encoded in `len2` bits, so each character of `s1` costs `len2 / 64`
+ * word operations. The match masks of the characters of `s2` live in the context and are
+ * cleared after the call, one character at a time.
+ * Like `edit_distance_dyn`, it skips the common prefix and suffix and tries diagonal
+ * transition first on long near-identical strings.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 Pointer to the first string.
+ * @param s2 Pointer to the second string.
+ * @return The edit distance between the two strings.
+ */
+int edit_distance_dyn_ctx(ed_context *context, const char *s1, const char *s2);
+
+/**
+ * @brief Computes the edit distance between two strings, giving up past a threshold, in a context.
+ * 
+ * This is `edit_distance_bounded` with its two rows taken from the context.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 Pointer to the first string.
+ * @param s2 Pointer to the second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance between the two strings if it is at most `max_distance`,
+ *         `max_distance + 1` otherwise.
+ */
+int edit_distance_bounded_ctx(ed_context *context, const char *s1, const char *s2, int max_distance);
+
+/**
+ * @brief Returns the code point buffer of a context, holding at least `count` code points.
+ * 
+ * Callers decode UTF-8 strings there once, before comparing them many times with
+ * `edit_distance_codepoints_ctx`. The buffer may move when it grows.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param count Number of code points needed.
+ * @return Pointer to the buffer.
+ */
+unsigned int *ed_context_codepoints(ed_context *context, size_t count);
+
+/**
+ * @brief Computes the edit distance between two strings of code points, giving up past a threshold.
+ * 
+ * This is `edit_distance_bounded_ctx` for strings decoded from UTF-8, so that a character
+ * written with several bytes costs one operation, not one per byte.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 Pointer to the code points of the first string.
+ * @param len1 Length of the first string.
+ * @param s2 Pointer to the code points of the second string.
+ * @param len2 Length of the second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance between the two strings if it is at most `max_distance`,
+ *         `max_distance + 1` otherwise.
+ */
+int edit_distance_codepoints_ctx(ed_context *context, const unsigned int *s1, int len1, const unsigned int *s2,
+                                 int len2, int max_distance);
+
+/**
+ * @brief Computes the edit distance between two UTF-8 strings, giving up past a threshold.
+ * 
+ * Strings made of ASCII characters only are compared byte by byte by
+ * `edit_distance_bounded_ctx`; otherwise both are decoded into the context and compared by
+ * `edit_distance_codepoints_ctx`.
+ * 
+ * @param context Pointer to the context of the calling thread.
+ * @param s1 Pointer to the first string.
+ * @param s2 Pointer to the second string.
+ * @param max_distance Largest distance the caller is interested in.
+ * @return The edit distance in code points if it is at most `max_distance`,
+ *         `max_distance + 1` otherwise.
+ */
+int edit_distance_utf8_ctx(ed_context *context, const char *s1, const char *s2, int max_distance);
+
 #endif // EDIT_DISTANCE_H
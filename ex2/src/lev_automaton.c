@@ -0,0 +1,175 @@
+#include "lev_automaton.h"
+#include <string.h>
+
+/**
+ * @brief State of the depth-first intersection of the two automata.
+ */
+typedef struct {
+    const lev_automaton *automaton;
+    char *buffer;       // Word spelled by the current path
+    size_t size;
+    char *result;
+    int best_distance;
+} lev_search;
+
+/**
+ * @brief Initializes the automaton of a query word.
+ *
+ * @param automaton Automaton to initialize.
+ * @param query Query word.
+ * @param max_distance Maximum allowed edit distance.
+ * @return 0 on success, -1 if the distance is not supported.
+ */
+int lev_automaton_init(lev_automaton *automaton, const char *query, int max_distance) {
+    if (max_distance < 0 || max_distance > LEV_AUTOMATON_MAX_DISTANCE) {
+        return -1;
+    }
+    automaton->query = query;
+    automaton->length = (int)strlen(query);
+    automaton->max_distance = max_distance;
+    return 0;
+}
+
+/**
+ * @brief Sets `state` to the initial state of the automaton.
+ *
+ * Before any symbol is read, the distance to a query prefix of length `j` is `j`.
+ *
+ * @param automaton Pointer to the automaton.
+ * @param state Output state.
+ */
+void lev_automaton_start(const lev_automaton *automaton, lev_state *state) {
+    int k = automaton->max_distance;
+    state->depth = 0;
+    for (int t = 0; t <= 2 * k; ++t) {
+        int j = t - k;
+        state->cells[t] = (unsigned char)((j >= 0 && j <= automaton->length) ? j : k + 1);
+    }
+}
+
+/**
+ * @brief Computes the state reached from `state` by reading the symbol `c`.
+ *
+ * This function applies one row of the insert/delete recurrence to the band of diagonals:
+ * a matching query character copies the diagonal predecessor, otherwise one operation is
+ * added to the best of the cell above and the cell on the left.
+ *
+ * @param automaton Pointer to the automaton.
+ * @param state Current state.
+ * @param c Symbol read.
+ * @param next Output state.
+ * @return The smallest distance recorded in the new state.
+ */
+int lev_automaton_step(const lev_automaton *automaton, const lev_state *state, unsigned char c, lev_state *next) {
+    int k = automaton->max_distance;
+    int limit = k + 1;
+    int depth = state->depth + 1;
+    int row_min = limit;
+
+    for (int t = 0; t <= 2 * k; ++t) {
+        int j = depth - k + t; // Query prefix length of this cell
+        int value;
+        if (j < 0 || j > automaton->length) {
+            value = limit;
+        } else if (j == 0) {
+            value = depth; // Every symbol read must be deleted
+        } else if ((unsigned char)automaton->query[j - 1] == c) {
+            value = state->cells[t]; // Diagonal predecessor
+        } else {
+            int above = (t < 2 * k) ? state->cells[t + 1] : limit;
+            int left = (t > 0) ? next->cells[t - 1] : limit;
+            value = 1 + ((above < left) ? above : left);
+        }
+        if (value > limit) value = limit;
+        next->cells[t] = (unsigned char)value;
+        if (value < row_min) row_min = value;
+    }
+    next->depth = depth;
+    return row_min;
+}
+
+/**
+ * @brief Returns the distance between the word read so far and the query.
+ *
+ * The whole query has been matched on the diagonal `length - depth`, which is inside the
+ * band only if the lengths differ by at most `max_distance`.
+ *
+ * @param automaton Pointer to the automaton.
+ * @param state Current state.
+ * @return The distance if the state is accepting, `max_distance + 1` otherwise.
+ */
+int lev_automaton_distance(const lev_automaton *automaton, const lev_state *state) {
+    int k = automaton->max_distance;
+    int t = automaton->length - state->depth + k;
+    if (t < 0 || t > 2 * k) {
+        return k + 1;
+    }
+    return state->cells[t];
+}
+
+/**
+ * @brief Visits the dictionary automaton from `node`, in the Levenshtein state `state`.
+ *
+ * @param search Search state.
+ * @param dictionary Pointer to the compact dictionary automaton.
+ * @param node Current state of the dictionary automaton.
+ * @param state Current state of the Levenshtein automaton.
+ */
+static void search_node(lev_search *search, const dawg_compact *dictionary, unsigned int node, const lev_state *state) {
+    if (node == (unsigned int)dictionary->nedges || (size_t)state->depth + 1 >= search->size) {
+        return; // No transitions, or longer words would not fit in the result buffer
+    }
+
+    for (unsigned int i = node; search->best_distance > 0; ++i) {
+        unsigned int target = dictionary->targets[i];
+        lev_state next;
+        int row_min = lev_automaton_step(search->automaton, state, dictionary->labels[i], &next);
+
+        // Distances never decrease along a path, so this branch cannot beat the best word
+        if (row_min < search->best_distance) {
+            search->buffer[state->depth] = (char)dictionary->labels[i];
+            if (target & DAWG_FINAL_BIT) {
+                int distance = lev_automaton_distance(search->automaton, &next);
+                if (distance < search->best_distance) {
+                    search->best_distance = distance;
+                    memcpy(search->result, search->buffer, (size_t)next.depth);
+                    search->result[next.depth] = '\0';
+                }
+            }
+            search_node(search, dictionary, target & DAWG_TARGET_MASK, &next);
+        }
+
+        if (target & DAWG_LAST_BIT) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Finds the dictionary word closest to the query by intersecting the two automata.
+ *
+ * @param automaton Pointer to the Levenshtein automaton of the query.
+ * @param dictionary Pointer to the dictionary automaton, in the compact layout.
+ * @param result Buffer receiving the closest word.
+ * @param size Size of the buffer.
+ * @return The distance of the closest word, or -1 if no word is within `max_distance`.
+ */
+int lev_automaton_find_closest(const lev_automaton *automaton, const dawg_compact *dictionary, char *result, size_t size) {
+    char buffer[size];
+    lev_search search;
+    search.automaton = automaton;
+    search.buffer = buffer;
+    search.size = size;
+    search.result = result;
+    search.best_distance = automaton->max_distance + 1;
+
+    lev_state start;
+    lev_automaton_start(automaton, &start);
+    if (dictionary->root_final && lev_automaton_distance(automaton, &start) < search.best_distance) {
+        search.best_distance = lev_automaton_distance(automaton, &start);
+        result[0] = '\0';
+    }
+    search_node(&search, dictionary, dictionary->root, &start);
+
+    return (search.best_distance <= automaton->max_distance) ? search.best_distance : -1;
+}
@@ -0,0 +1,91 @@
+#ifndef LEV_AUTOMATON_H
+#define LEV_AUTOMATON_H
+
+#include <stddef.h>
+#include "dawg.h"
+
+#define LEV_AUTOMATON_MAX_DISTANCE 2 // Largest edit distance supported by the automaton
+
+/**
+ * @brief Levenshtein automaton of a query word for the insert/delete edit distance.
+ *
+ * The automaton accepts exactly the words within `max_distance` edits of the query.
+ * It is deterministic and universal: a state only records the last row of the dynamic
+ * programming table restricted to the `2 * max_distance + 1` diagonals around the main
+ * one, and a transition only depends on which of the query characters on those diagonals
+ * match the input symbol.
+ */
+typedef struct {
+    const char *query;
+    int length;
+    int max_distance;
+} lev_automaton;
+
+/**
+ * @brief A state of the Levenshtein automaton.
+ *
+ * `cells[t]` is the distance between the `depth` characters read so far and the first
+ * `depth - max_distance + t` characters of the query, capped at `max_distance + 1`.
+ */
+typedef struct {
+    unsigned char cells[2 * LEV_AUTOMATON_MAX_DISTANCE + 1];
+    int depth;
+} lev_state;
+
+/**
+ * @brief Initializes the automaton of a query word.
+ *
+ * @param automaton Automaton to initialize.
+ * @param query Query word; it must stay valid while the automaton is used.
+ * @param max_distance Maximum allowed edit distance.
+ * @return 0 on success, -1 if `max_distance` is negative or larger than `LEV_AUTOMATON_MAX_DISTANCE`.
+ */
+int lev_automaton_init(lev_automaton *automaton, const char *query, int max_distance);
+
+/**
+ * @brief Sets `state` to the initial state of the automaton.
+ *
+ * @param automaton Pointer to the automaton.
+ * @param state Output state.
+ */
+void lev_automaton_start(const lev_automaton *automaton, lev_state *state);
+
+/**
+ * @brief Computes the state reached from `state` by reading the symbol `c`.
+ *
+ * @param automaton Pointer to the automaton.
+ * @param state Current state.
+ * @param c Symbol read.
+ * @param next Output state.
+ * @return The smallest distance recorded in the new state; the state is dead (no accepted
+ *         word can be reached from it) when this is larger than `max_distance`.
+ */
+int lev_automaton_step(const lev_automaton *automaton, const lev_state *state, unsigned char c, lev_state *next);
+
+/**
+ * @brief Returns the distance between the word read so far and the query.
+ *
+ * @param automaton Pointer to the automaton.
+ * @param state Current state.
+ * @return The distance if the state is accepting, `max_distance + 1` otherwise.
+ */
+int lev_automaton_distance(const lev_automaton *automaton, const lev_state *state);
+
+/**
+ * @brief Finds the dictionary word closest to the query by intersecting the two automata.
+ *
+ * The dictionary automaton is visited depth first together with the Levenshtein automaton,
+ * and a branch is abandoned as soon as the Levenshtein state dies or can no longer improve
+ * on the best word found so far; the work is thus proportional to the part of the
+ * dictionary within reach of the query, not to the dictionary size. Among equally close
+ * words the first in byte order is returned.
+ *
+ * @param automaton Pointer to the Levenshtein automaton of the query.
+ * @param dictionary Pointer to the dictionary automaton, in the compact layout.
+ * @param result Buffer receiving the closest word.
+ * @param size Size of the buffer.
+ * @return The distance of the closest word, or -1 if no word is within `max_distance`.
+ */
+int lev_automaton_find_closest(const lev_automaton *automaton, const dawg_compact *dictionary, char *result, size_t size);
+
+#endif // LEV_AUTOMATON_H
@@ -0,0 +1,535 @@
+#include "line_diff.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DIFF_CONTEXT 3 // Lines of context printed around each hunk
+
+/**
+ * @brief Working state shared by the recursive steps of `myers_diff`.
+ *
+ * The two `v` arrays hold the furthest-reaching points of the forward and backward
+ * searches. They are allocated once for the whole comparison and reused by every
+ * bisection, which keeps the memory usage linear in the input size.
+ */
+typedef struct {
+    const unsigned int *a;
+    const unsigned int *b;
+    char *changed_a;
+    char *changed_b;
+    int *v1;
+    int *v2;
+    int distance;
+} diff_state;
+
+/**
+ * @brief A file being compared, split into lines with their interned ids.
+ */
+typedef struct {
+    char *data;          // Contents of the file
+    char **lines;        // Start of each line inside `data`
+    int *lengths;        // Length of each line, without the newline
+    unsigned int *ids;   // Interned id of each line
+    int count;           // Number of lines
+    int missing_newline; // Whether the last line has no newline
+} diff_file;
+
+/**
+ * @brief A slot of the table used to intern lines into integer ids.
+ */
+typedef struct {
+    const char *line;
+    int length;
+    int missing_newline;
+    unsigned long long hash;
+    unsigned int id;
+} intern_slot;
+
+/**
+ * @brief A single step of the edit script: `' '` keeps, `'-'` deletes, `'+'` inserts a line.
+ *
+ * `a` and `b` are the positions reached in the two files when the step is taken.
+ */
+typedef struct {
+    char op;
+    int a;
+    int b;
+} diff_op;
+
+/**
+ * @brief Flags a range of elements as changed and accounts for them in the distance.
+ *
+ * @param st Diff state.
+ * @param flags Flag array to update (may be NULL).
+ * @param from First element of the range.
+ * @param count Number of elements in the range.
+ */
+static void mark_range(diff_state *st, char *flags, int from, int count) {
+    st->distance += count;
+    if (flags && count > 0) {
+        memset(flags + from, 1, (size_t)count);
+    }
+}
+
+/**
+ * @brief Finds the middle snake of the edit graph between `a[a_lo..a_hi)` and `b[b_lo..b_hi)`.
+ *
+ * The forward and backward searches advance one edit at a time and stop as soon as their
+ * furthest-reaching paths overlap; the overlap point splits the problem into two halves,
+ * each with roughly half of the differences.
+ *
+ * @param st Diff state.
+ * @param a_lo Start of the range in the first sequence.
+ * @param a_hi End of the range in the first sequence.
+ * @param b_lo Start of the range in the second sequence.
+ * @param b_hi End of the range in the second sequence.
+ * @param split_x Output split position in the first sequence.
+ * @param split_y Output split position in the second sequence.
+ * @return 1 if a split point was found, 0 if the two ranges have nothing in common.
+ */
+static int bisect(diff_state *st, int a_lo, int a_hi, int b_lo, int b_hi, int *split_x, int *split_y) {
+    const unsigned int *a = st->a + a_lo;
+    const unsigned int *b = st->b + b_lo;
+    int len1 = a_hi - a_lo;
+    int len2 = b_hi - b_lo;
+    int max_d = (len1 + len2 + 1) / 2;
+    int v_offset = max_d;
+    int v_length = 2 * max_d;
+    int *v1 = st->v1;
+    int *v2 = st->v2;
+
+    for (int i = 0; i < v_length + 2; ++i) {
+        v1[i] = -1;
+        v2[i] = -1;
+    }
+    v1[v_offset + 1] = 0;
+    v2[v_offset + 1] = 0;
+
+    int delta = len1 - len2;
+    int front = (delta % 2 != 0); // With an odd delta the overlap is detected on the forward pass
+    int k1start = 0, k1end = 0, k2start = 0, k2end = 0;
+
+    for (int d = 0; d < max_d; ++d) {
+        // Forward search
+        for (int k1 = -d + k1start; k1 <= d - k1end; k1 += 2) {
+            int k1_offset = v_offset + k1;
+            int x1;
+            if (k1 == -d || (k1 != d && v1[k1_offset - 1] < v1[k1_offset + 1])) {
+                x1 = v1[k1_offset + 1]; // Move down (insertion)
+            } else {
+                x1 = v1[k1_offset - 1] + 1; // Move right (deletion)
+            }
+            int y1 = x1 - k1;
+            while (x1 < len1 && y1 < len2 && a[x1] == b[y1]) {
+                x1++;
+                y1++;
+            }
+            v1[k1_offset] = x1;
+            if (x1 > len1) {
+                k1end += 2; // Ran off the right of the graph
+            } else if (y1 > len2) {
+                k1start += 2; // Ran off the bottom of the graph
+            } else if (front) {
+                int k2_offset = v_offset + delta - k1;
+                if (k2_offset >= 0 && k2_offset < v_length && v2[k2_offset] != -1) {
+                    int x2 = len1 - v2[k2_offset];
+                    if (x1 >= x2) {
+                        *split_x = a_lo + x1;
+                        *split_y = b_lo + y1;
+                        return 1;
+                    }
+                }
+            }
+        }
+
+        // Backward search
+        for (int k2 = -d + k2start; k2 <= d - k2end; k2 += 2) {
+            int k2_offset = v_offset + k2;
+            int x2;
+            if (k2 == -d || (k2 != d && v2[k2_offset - 1] < v2[k2_offset + 1])) {
+                x2 = v2[k2_offset + 1];
+            } else {
+                x2 = v2[k2_offset - 1] + 1;
+            }
+            int y2 = x2 - k2;
+            while (x2 < len1 && y2 < len2 && a[len1 - x2 - 1] == b[len2 - y2 - 1]) {
+                x2++;
+                y2++;
+            }
+            v2[k2_offset] = x2;
+            if (x2 > len1) {
+                k2end += 2;
+            } else if (y2 > len2) {
+                k2start += 2;
+            } else if (!front) {
+                int k1_offset = v_offset + delta - k2;
+                if (k1_offset >= 0 && k1_offset < v_length && v1[k1_offset] != -1) {
+                    int x1 = v1[k1_offset];
+                    int y1 = v_offset + x1 - k1_offset;
+                    if (x1 >= len1 - x2) {
+                        *split_x = a_lo + x1;
+                        *split_y = b_lo + y1;
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Recursively computes the edit script between `a[a_lo..a_hi)` and `b[b_lo..b_hi)`.
+ *
+ * Common prefixes and suffixes are skipped first, so that identical regions cost only a
+ * linear scan; the remaining ranges are split at their middle snake.
+ *
+ * @param st Diff state.
+ * @param a_lo Start of the range in the first sequence.
+ * @param a_hi End of the range in the first sequence.
+ * @param b_lo Start of the range in the second sequence.
+ * @param b_hi End of the range in the second sequence.
+ */
+static void diff_range(diff_state *st, int a_lo, int a_hi, int b_lo, int b_hi) {
+    while (a_lo < a_hi && b_lo < b_hi && st->a[a_lo] == st->b[b_lo]) {
+        a_lo++;
+        b_lo++;
+    }
+    while (a_lo < a_hi && b_lo < b_hi && st->a[a_hi - 1] == st->b[b_hi - 1]) {
+        a_hi--;
+        b_hi--;
+    }
+
+    if (a_lo == a_hi) {
+        mark_range(st, st->changed_b, b_lo, b_hi - b_lo); // Everything left in b is inserted
+        return;
+    }
+    if (b_lo == b_hi) {
+        mark_range(st, st->changed_a, a_lo, a_hi - a_lo); // Everything left in a is deleted
+        return;
+    }
+
+    int x, y;
+    if (!bisect(st, a_lo, a_hi, b_lo, b_hi, &x, &y)) {
+        mark_range(st, st->changed_a, a_lo, a_hi - a_lo);
+        mark_range(st, st->changed_b, b_lo, b_hi - b_lo);
+        return;
+    }
+
+    diff_range(st, a_lo, x, b_lo, y);
+    diff_range(st, x, a_hi, y, b_hi);
+}
+
+/**
+ * @brief Computes a minimal insert/delete edit script between two integer sequences.
+ * 
+ * This function allocates the scratch arrays of the furthest-reaching points once and
+ * runs the recursive linear-space refinement of Myers' algorithm on the whole input.
+ * 
+ * @param a First sequence.
+ * @param n Length of the first sequence.
+ * @param b Second sequence.
+ * @param m Length of the second sequence.
+ * @param changed_a Output array of `n` flags marking the deleted elements (may be NULL).
+ * @param changed_b Output array of `m` flags marking the inserted elements (may be NULL).
+ * @return The edit distance between the two sequences.
+ */
+int myers_diff(const unsigned int *a, int n, const unsigned int *b, int m, char *changed_a, char *changed_b) {
+    diff_state st;
+    st.a = a;
+    st.b = b;
+    st.changed_a = changed_a;
+    st.changed_b = changed_b;
+    st.distance = 0;
+
+    if (changed_a && n > 0) memset(changed_a, 0, (size_t)n);
+    if (changed_b && m > 0) memset(changed_b, 0, (size_t)m);
+
+    size_t v_size = (size_t)(n + m + 1) / 2 * 2 + 2;
+    st.v1 = malloc(2 * v_size * sizeof(int));
+    if (!st.v1) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    st.v2 = st.v1 + v_size;
+
+    diff_range(&st, 0, n, 0, m);
+
+    free(st.v1);
+    return st.distance;
+}
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a line.
+ *
+ * @param line Pointer to the line.
+ * @param length Length of the line.
+ * @return The hash of the line.
+ */
+static unsigned long long hash_line(const char *line, int length) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int i = 0; i < length; ++i) {
+        hash ^= (unsigned char)line[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Reads a file into memory and splits it into lines.
+ *
+ * @param path Path to the file.
+ * @param file Output structure describing the lines of the file.
+ * @return 0 on success, -1 if the file cannot be read.
+ */
+static int read_lines(const char *path, diff_file *file) {
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        perror("Error opening file to compare");
+        return -1;
+    }
+
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    if (size < 0) {
+        perror("Error reading file to compare");
+        fclose(in);
+        return -1;
+    }
+
+    file->data = malloc((size_t)size + 1);
+    if (!file->data) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    size_t read = fread(file->data, 1, (size_t)size, in);
+    fclose(in);
+    file->data[read] = '\0';
+
+    int count = 0;
+    for (size_t i = 0; i < read; ++i) {
+        if (file->data[i] == '\n') count++;
+    }
+    file->missing_newline = (read > 0 && file->data[read - 1] != '\n');
+    if (file->missing_newline) count++;
+
+    file->count = count;
+    file->lines = malloc((size_t)(count + 1) * sizeof(char *));
+    file->lengths = malloc((size_t)(count + 1) * sizeof(int));
+    file->ids = malloc((size_t)(count + 1) * sizeof(unsigned int));
+    if (!file->lines || !file->lengths || !file->ids) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    char *start = file->data;
+    for (int i = 0; i < count; ++i) {
+        char *end = strchr(start, '\n');
+        if (!end) end = file->data + read;
+        file->lines[i] = start;
+        file->lengths[i] = (int)(end - start);
+        start = end + 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Tells whether a line is the last one of a file that does not end with a newline.
+ *
+ * @param file File the line belongs to.
+ * @param i Index of the line.
+ * @return Non-zero value if the line has no newline, zero otherwise.
+ */
+static int lacks_newline(const diff_file *file, int i) {
+    return file->missing_newline && i == file->count - 1;
+}
+
+/**
+ * @brief Assigns the same integer id to equal lines of the two files.
+ *
+ * Lines are looked up by hash in an open-addressing table; collisions are resolved by
+ * comparing the contents, so two lines share an id only if they are identical. A last
+ * line without newline differs from the same text followed by a newline, as for `diff`.
+ *
+ * @param f1 First file.
+ * @param f2 Second file.
+ */
+static void intern_lines(diff_file *f1, diff_file *f2) {
+    size_t capacity = 16;
+    while (capacity < 2 * (size_t)(f1->count + f2->count)) capacity <<= 1;
+
+    intern_slot *table = calloc(capacity, sizeof(intern_slot));
+    if (!table) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned int next_id = 0;
+    diff_file *files[2] = {f1, f2};
+    for (int f = 0; f < 2; ++f) {
+        for (int i = 0; i < files[f]->count; ++i) {
+            const char *line = files[f]->lines[i];
+            int length = files[f]->lengths[i];
+            int missing_newline = lacks_newline(files[f], i);
+            unsigned long long hash = hash_line(line, length);
+            size_t slot = (size_t)hash & (capacity - 1);
+            while (table[slot].line &&
+                   (table[slot].hash != hash || table[slot].length != length ||
+                    table[slot].missing_newline != missing_newline ||
+                    memcmp(table[slot].line, line, (size_t)length) != 0)) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            if (!table[slot].line) {
+                table[slot].line = line;
+                table[slot].length = length;
+                table[slot].missing_newline = missing_newline;
+                table[slot].hash = hash;
+                table[slot].id = next_id++;
+            }
+            files[f]->ids[i] = table[slot].id;
+        }
+    }
+
+    free(table);
+}
+
+/**
+ * @brief Frees the memory held by a file read with `read_lines`.
+ *
+ * @param file File to release.
+ */
+static void free_lines(diff_file *file) {
+    free(file->data);
+    free(file->lines);
+    free(file->lengths);
+    free(file->ids);
+}
+
+/**
+ * @brief Writes the edit script as unified-style hunks.
+ *
+ * Changes closer than twice the context size are merged into the same hunk. A last line
+ * without newline is followed by the `\ No newline at end of file` marker of `diff`.
+ *
+ * @param out Output stream.
+ * @param ops Edit script.
+ * @param nops Number of steps of the edit script.
+ * @param f1 Original file.
+ * @param f2 Modified file.
+ */
+static void print_hunks(FILE *out, const diff_op *ops, int nops, const diff_file *f1, const diff_file *f2) {
+    int k = 0;
+    while (k < nops) {
+        if (ops[k].op == ' ') {
+            k++;
+            continue;
+        }
+
+        // Extend the hunk while the next change is within the context window
+        int last = k;
+        int j = k + 1;
+        while (j < nops) {
+            if (ops[j].op != ' ') {
+                last = j++;
+                continue;
+            }
+            int run = j;
+            while (run < nops && ops[run].op == ' ') run++;
+            if (run == nops || run - j > 2 * DIFF_CONTEXT) break;
+            j = run;
+        }
+
+        int start = (k - DIFF_CONTEXT > 0) ? k - DIFF_CONTEXT : 0;
+        int stop = (last + 1 + DIFF_CONTEXT < nops) ? last + 1 + DIFF_CONTEXT : nops;
+
+        int a_count = 0, b_count = 0;
+        for (int i = start; i < stop; ++i) {
+            if (ops[i].op != '+') a_count++;
+            if (ops[i].op != '-') b_count++;
+        }
+        // An empty range is identified by the line preceding it
+        fprintf(out, "@@ -%d,%d +%d,%d @@\n",
+                a_count ? ops[start].a + 1 : ops[start].a, a_count,
+                b_count ? ops[start].b + 1 : ops[start].b, b_count);
+
+        for (int i = start; i < stop; ++i) {
+            int missing_newline;
+            if (ops[i].op == '+') {
+                fprintf(out, "+%.*s\n", f2->lengths[ops[i].b], f2->lines[ops[i].b]);
+                missing_newline = lacks_newline(f2, ops[i].b);
+            } else {
+                fprintf(out, "%c%.*s\n", ops[i].op, f1->lengths[ops[i].a], f1->lines[ops[i].a]);
+                missing_newline = lacks_newline(f1, ops[i].a);
+            }
+            if (missing_newline) fprintf(out, "\\ No newline at end of file\n");
+        }
+
+        k = stop;
+    }
+}
+
+/**
+ * @brief Compares two text files line by line and writes a unified-style edit script.
+ * 
+ * This function reads both files, interns their lines into integer ids, computes the
+ * edit script with `myers_diff` and prints it as hunks. Nothing is printed when the
+ * files are identical.
+ * 
+ * @param file1 Path to the original file.
+ * @param file2 Path to the modified file.
+ * @param out Stream the edit script is written to.
+ * @return The number of inserted and deleted lines, or -1 if a file cannot be read.
+ */
+int line_diff_files(const char *file1, const char *file2, FILE *out) {
+    diff_file f1, f2;
+    if (read_lines(file1, &f1) != 0) return -1;
+    if (read_lines(file2, &f2) != 0) {
+        free_lines(&f1);
+        return -1;
+    }
+
+    intern_lines(&f1, &f2);
+
+    char *changed_a = malloc((size_t)f1.count + 1);
+    char *changed_b = malloc((size_t)f2.count + 1);
+    diff_op *ops = malloc((size_t)(f1.count + f2.count + 1) * sizeof(diff_op));
+    if (!changed_a || !changed_b || !ops) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    int distance = myers_diff(f1.ids, f1.count, f2.ids, f2.count, changed_a, changed_b);
+
+    if (distance > 0) {
+        // Turn the change flags into an ordered script, deletions before insertions
+        int nops = 0, i = 0, j = 0;
+        while (i < f1.count || j < f2.count) {
+            ops[nops].a = i;
+            ops[nops].b = j;
+            if (i < f1.count && changed_a[i]) {
+                ops[nops].op = '-';
+                i++;
+            } else if (j < f2.count && changed_b[j]) {
+                ops[nops].op = '+';
+                j++;
+            } else {
+                ops[nops].op = ' ';
+                i++;
+                j++;
+            }
+            nops++;
+        }
+
+        fprintf(out, "--- %s\n+++ %s\n", file1, file2);
+        print_hunks(out, ops, nops, &f1, &f2);
+    }
+
+    free(ops);
+    free(changed_a);
+    free(changed_b);
+    free_lines(&f1);
+    free_lines(&f2);
+    return distance;
+}
@@ -0,0 +1,39 @@
+#ifndef LINE_DIFF_H
+#define LINE_DIFF_H
+
+#include <stdio.h>
+
+/**
+ * @brief Computes a minimal insert/delete edit script between two integer sequences.
+ *
+ * This function runs Myers' O(ND) greedy algorithm with the linear-space "middle snake"
+ * refinement, so its running time grows with the size of the difference `D` rather than
+ * with the product of the lengths. The script is returned as two flag arrays: an element
+ * of `a` flagged in `changed_a` must be deleted, an element of `b` flagged in `changed_b`
+ * must be inserted, every other element is kept.
+ *
+ * @param a First sequence.
+ * @param n Length of the first sequence.
+ * @param b Second sequence.
+ * @param m Length of the second sequence.
+ * @param changed_a Output array of `n` flags (may be NULL when only the distance is needed).
+ * @param changed_b Output array of `m` flags (may be NULL when only the distance is needed).
+ * @return The edit distance (number of insertions and deletions) between the two sequences.
+ */
+int myers_diff(const unsigned int *a, int n, const unsigned int *b, int m, char *changed_a, char *changed_b);
+
+/**
+ * @brief Compares two text files line by line and writes a unified-style edit script.
+ *
+ * Every line is hashed and interned into an integer id, so that the two files can be
+ * compared with `myers_diff` using the same insert/delete cost model as `edit_distance_dyn`.
+ * The script is written with `---`/`+++` headers and `@@` hunks with three lines of context.
+ *
+ * @param file1 Path to the original file.
+ * @param file2 Path to the modified file.
+ * @param out Stream the edit script is written to.
+ * @return The number of inserted and deleted lines, or -1 if a file cannot be read.
+ */
+int line_diff_files(const char *file1, const char *file2, FILE *out);
+
+#endif // LINE_DIFF_H
@@ -2,10 +2,60 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include "edit_distance.h"
+#include "line_diff.h"
+#include "similarity_join.h"
+#include "dawg.h"
+#include "lev_automaton.h"
+#include "ed_cursor.h"
+#include "qgram_index.h"
+#include "word_set.h"
+#include "bloom_filter.h"
+#include "wavefront.h"
+#include "batch_search.h"
+#include "utf8.h"
 
 #define MAXLEN 100000 // Maximum length of strings considered
 #define MAX_WORD_LENGTH 1000  // Maximum length of a word
+#define QGRAM_LENGTH 2 // Length of the q-grams indexed by the q-gram search
+#define SERVER_MAX_BATCH 100000 // Default maximum number of lines of a batch request
+
+/**
+ * @brief Strategy used to search the dictionary for the closest word.
+ */
+typedef enum {
+    SEARCH_LINEAR,    // Compare the word with every dictionary word (`find_closest_word`)
+    SEARCH_AUTOMATON, // Intersect a Levenshtein automaton with the dictionary automaton
+    SEARCH_QGRAM      // Verify the candidates of a positional q-gram index
+} search_backend;
+
+/**
+ * @brief Format of the statistics printed after a correction run.
+ */
+typedef enum {
+    STATS_OFF,        // No statistics are collected
+    STATS_TEXT,       // Human-readable summary
+    STATS_JSON        // One JSON object
+} stats_format;
+
+/**
+ * @brief Options of the text correction.
+ */
+typedef struct {
+    search_backend backend;
+    stats_format stats;
+    int bloom;                          // Check a Bloom filter before the dictionary set
+    double bloom_false_positive_rate;
+    size_t bloom_bytes;                 // Size of the Bloom filter, 0 to derive it from the rate
+} correction_options;
 
 /**
  * @brief Checks if a character is a letter.
@@ -22,17 +72,32 @@ int is_letter(char c) {
 /**
  * @brief Removes punctuation from a word.
  * 
- * This function removes any non-letter characters from the input word.
+ * This function removes any non-letter characters from the input word, which is read as
+ * UTF-8 so that accented letters are kept whole. Runs of eight ASCII bytes, checked with
+ * `utf8_is_ascii`, are filtered byte by byte with `is_letter`; the other characters are
+ * decoded and tested with `utf8_is_letter`.
  * 
  * @param word Pointer to the word from which punctuation should be removed.
  */
 void remove_punctuation(char *word) {
     char *src = word, *dst = word;
-    while (*src) {
-        if (is_letter(*src)) {
-            *dst++ = *src;
+    char *end = word + strlen(word);
+    while (src < end) {
+        if (end - src >= 8 && utf8_is_ascii(src, 8)) {
+            for (int i = 0; i < 8; ++i, ++src) {
+                if (is_letter(*src)) {
+                    *dst++ = *src;
+                }
+            }
+            continue;
+        }
+        unsigned int codepoint;
+        int n = utf8_decode_char(src, &codepoint);
+        if (utf8_is_letter(codepoint)) {
+            memmove(dst, src, (size_t)n);
+            dst += n;
         }
-        src++;
+        src += n;
     }
     *dst = '\0';
 }
@@ -41,19 +106,38 @@ void remove_punctuation(char *word) {
  * @brief Finds the closest word in the dictionary to the given word.
  * 
  * This function searches for the word in the dictionary that has the smallest edit distance
- * to the given word and is within the specified edit distance threshold.
+ * to the given word and is within the specified edit distance threshold. Distances count
+ * code points: pairs of ASCII words go to the bit-parallel byte kernel, any other pair is
+ * compared with `edit_distance_codepoints_ctx`, the word being decoded once per call and the
+ * dictionary once for all in `decoded`, whose lengths also skip the words too long or too
+ * short to be within the threshold, as `find_closest_words` does.
  * 
  * @param word Pointer to the word to be corrected.
  * @param dictionary Array of pointers to dictionary words.
  * @param dict_size Number of words in the dictionary.
+ * @param decoded Dictionary decoded by `utf8_words_decode`.
  * @param edit_distance_threshold Maximum allowed edit distance.
+ * @param context Edit distance context of the calling thread.
  * @return Pointer to the closest word found in the dictionary, or NULL if no close word is found.
  */
-char* find_closest_word(char *word, char **dictionary, int dict_size, int edit_distance_threshold) {
+char* find_closest_word(char *word, char **dictionary, int dict_size, const utf8_words *decoded,
+                        int edit_distance_threshold, ed_context *context) {
     int min_distance = MAXLEN;
     char *closest_word = NULL;
+    unsigned int query[MAX_WORD_LENGTH], buffer[MAX_WORD_LENGTH];
+    int ascii = utf8_is_ascii(word, strlen(word));
+    int length = utf8_decode(word, query);
     for (int i = 0; i < dict_size; ++i) {
-        int dist = edit_distance_dyn(word, dictionary[i]);
+        int difference = length - decoded->lengths[i];
+        if (difference > edit_distance_threshold || -difference > edit_distance_threshold) continue;
+        int dist;
+        if (ascii && decoded->start[i] < 0) {
+            dist = edit_distance_dyn_ctx(context, word, dictionary[i]);
+        } else {
+            const unsigned int *candidate = utf8_words_codepoints(decoded, dictionary, i, buffer);
+            dist = edit_distance_codepoints_ctx(context, query, length, candidate, decoded->lengths[i],
+                                                edit_distance_threshold);
+        }
         if (dist <= edit_distance_threshold && dist < min_distance) {
             min_distance = dist;
             closest_word = dictionary[i];
@@ -63,18 +147,16 @@ char* find_closest_word(char *word, char **dictionary, int dict_size, int edit_d
 }
 
 /**
- * @brief Corrects the text using the provided dictionary.
- * 
- * This function reads a text file, processes each word by removing punctuation, checks if the
- * word is in the dictionary, and if not, replaces it with the closest word from the dictionary
- * that is within the edit distance threshold. The corrected text is then written to an output file.
+ * @brief Reads the dictionary from a file, one word per line.
  * 
  * @param dictionary_file Path to the dictionary file.
- * @param text_file Path to the text file to be corrected.
+ * @param dict_size Output number of words read.
+ * @param log Stream the progress messages are written to.
+ * @return Array of pointers to the dictionary words.
  */
-void correct_text(const char *dictionary_file, const char *text_file) {
+char **load_dictionary(const char *dictionary_file, int *dict_size, FILE *log) {
     char **dictionary = NULL;
-    int dict_size = 0;
+    *dict_size = 0;
 
     // Open the dictionary file
     FILE *dict = fopen(dictionary_file, "r");
@@ -83,32 +165,592 @@ void correct_text(const char *dictionary_file, const char *text_file) {
         exit(EXIT_FAILURE);
     }
 
-    printf("Dictionary file opened successfully.\n");
+    fprintf(log, "Dictionary file opened successfully.\n");
 
     // Read the dictionary
     char line[MAX_WORD_LENGTH];
     while (fgets(line, sizeof(line), dict)) {
         line[strcspn(line, "\n")] = '\0'; // Remove newline character
         // Reallocate memory for a new word
-        char **temp = realloc(dictionary, (dict_size + 1) * sizeof(char *));
+        char **temp = realloc(dictionary, (size_t)(*dict_size + 1) * sizeof(char *));
         if (!temp) {
             perror("Memory allocation error");
             exit(EXIT_FAILURE);
         }
         dictionary = temp;
         // Allocate memory for the new word
-        dictionary[dict_size] = malloc(strlen(line) + 1);
-        if (!dictionary[dict_size]) {
+        dictionary[*dict_size] = malloc(strlen(line) + 1);
+        if (!dictionary[*dict_size]) {
             perror("Memory allocation error");
             exit(EXIT_FAILURE);
         }
         // Copy the word into the dictionary
-        strcpy(dictionary[dict_size], line);
-        dict_size++;
+        strcpy(dictionary[*dict_size], line);
+        (*dict_size)++;
     }
     fclose(dict);
 
-    printf("Dictionary read successfully. Number of words: %d\n", dict_size);
+    fprintf(log, "Dictionary read successfully. Number of words: %d\n", *dict_size);
+    return dictionary;
+}
+
+/**
+ * @brief Frees the memory allocated for the dictionary.
+ * 
+ * @param dictionary Array of pointers to dictionary words.
+ * @param dict_size Number of words in the dictionary.
+ */
+void free_dictionary(char **dictionary, int dict_size) {
+    for (int i = 0; i < dict_size; ++i) {
+        free(dictionary[i]);
+    }
+    free(dictionary);
+}
+
+/**
+ * @brief Finds the closest word in the dictionary automaton to the given word.
+ * 
+ * This function is the automaton counterpart of `find_closest_word`. Thresholds the
+ * Levenshtein automaton does not support are searched with an incremental cursor instead.
+ * 
+ * @param word Pointer to the word to be corrected.
+ * @param automaton Pointer to the dictionary automaton.
+ * @param edit_distance_threshold Maximum allowed edit distance.
+ * @param buffer Buffer of `MAX_WORD_LENGTH` characters receiving the closest word.
+ * @return Pointer to the closest word found, or NULL if no close word is found.
+ */
+char *find_closest_word_automaton(char *word, const dawg_compact *automaton, int edit_distance_threshold, char *buffer) {
+    lev_automaton query;
+    if (lev_automaton_init(&query, word, edit_distance_threshold) != 0) {
+        if (ed_cursor_find_closest(word, automaton, edit_distance_threshold, buffer, MAX_WORD_LENGTH) < 0) {
+            return NULL;
+        }
+        return buffer;
+    }
+    if (lev_automaton_find_closest(&query, automaton, buffer, MAX_WORD_LENGTH) < 0) {
+        return NULL;
+    }
+    return buffer;
+}
+
+/**
+ * @brief Growable text buffer holding corrected lines.
+ */
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;
+} text_buffer;
+
+/**
+ * @brief Appends a string to a text buffer.
+ * 
+ * @param buffer Pointer to the buffer.
+ * @param s String to append.
+ */
+void text_buffer_append(text_buffer *buffer, const char *s) {
+    size_t n = strlen(s);
+    if (buffer->length + n + 1 > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 256;
+        while (capacity < buffer->length + n + 1) capacity *= 2;
+        char *temp = realloc(buffer->data, capacity);
+        if (!temp) {
+            perror("Memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+        buffer->data = temp;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, s, n + 1);
+    buffer->length += n;
+}
+
+/**
+ * @brief Dictionary and search structures shared by every correction, built once.
+ * 
+ * A corrector is only read while correcting, so any number of threads can use it, each
+ * with its own `correction_scratch`.
+ */
+typedef struct {
+    char **dictionary;
+    int dict_size;
+    int edit_distance_threshold;
+    stats_format stats;         // Whether the threads collect statistics, and how they are printed
+    word_set *members;          // Case-insensitive dictionary set
+    bloom_filter *filter;       // Checked before `members`, or NULL
+    dawg_compact *automaton;    // Used by `SEARCH_AUTOMATON`, or NULL
+    qgram_index *qgrams;        // Used by `SEARCH_QGRAM`, or NULL
+    utf8_words *decoded;        // Used by `SEARCH_LINEAR`, or NULL
+} corrector;
+
+/**
+ * @brief Counters and timers of the stages of the correction.
+ * 
+ * Candidates are the calls to the edit distance kernels, so the automaton search, which
+ * walks the dictionary automaton instead, examines none.
+ */
+typedef struct {
+    long long tokens;            // Words read
+    long long hits;              // Words found in the dictionary
+    long long bloom_rejections;  // Words rejected by the Bloom filter without probing the set
+    long long searches;          // Closest word searches
+    long long corrections;       // Words replaced
+    long long candidates;        // Dictionary words compared by the searches
+    long long cells;             // Table cells evaluated by the edit distance kernels
+    long long tokenize_ns;       // Splitting the lines and removing punctuation
+    long long membership_ns;     // Dictionary lookups
+    long long search_ns;         // Candidate generation and verification
+    long long output_ns;         // Writing the corrected words
+} correction_stats;
+
+/**
+ * @brief Corrections of the misspelled words of a text, searched in advance in one batch.
+ */
+typedef struct {
+    char **words;                // Distinct misspelled words, sorted
+    char **corrections;          // Closest dictionary word of each, or NULL
+    int count;
+} correction_table;
+
+/**
+ * @brief Scratch memory of a thread correcting text.
+ */
+typedef struct {
+    ed_context *context;
+    qgram_scratch *scratch;
+    const correction_table *table; // Corrections searched in advance, or NULL
+    char automaton_word[MAX_WORD_LENGTH];
+    int collect_stats;
+    correction_stats stats;      // Statistics of this thread, cells of its context excluded
+} correction_scratch;
+
+/**
+ * @brief Returns the current time of the monotonic clock in nanoseconds.
+ * 
+ * @return The current time.
+ */
+static long long now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+/**
+ * @brief Loads the dictionary and builds the structures required by the options.
+ * 
+ * @param dictionary_file Path to the dictionary file.
+ * @param options Correction options.
+ * @param log Stream the progress messages are written to.
+ * @return Pointer to the new corrector.
+ */
+corrector *corrector_create(const char *dictionary_file, const correction_options *options, FILE *log) {
+    corrector *c = malloc(sizeof(corrector));
+    if (!c) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    c->dictionary = load_dictionary(dictionary_file, &c->dict_size, log);
+    c->edit_distance_threshold = 2; // Can be adjusted as needed
+    c->stats = options->stats;
+    c->members = word_set_build(c->dictionary, c->dict_size);
+
+    c->filter = NULL;
+    if (options->bloom) {
+        c->filter = bloom_filter_create((size_t)c->members->count, options->bloom_false_positive_rate, options->bloom_bytes);
+        for (size_t slot = 0; slot < c->members->capacity; ++slot) {
+            if (c->members->words[slot]) {
+                bloom_filter_add(c->filter, c->members->hashes[slot]);
+            }
+        }
+        fprintf(log, "Bloom filter built: %zu bytes, %d hashes per word.\n", bloom_filter_memory(c->filter), c->filter->nhashes);
+    }
+
+    c->automaton = NULL;
+    if (options->backend == SEARCH_AUTOMATON) {
+        c->automaton = dawg_compact_from_words(c->dictionary, c->dict_size);
+        fprintf(log, "Dictionary automaton built: %d transitions, %zu bytes.\n", c->automaton->nedges,
+                dawg_compact_memory(c->automaton));
+    }
+    c->qgrams = NULL;
+    if (options->backend == SEARCH_QGRAM) {
+        c->qgrams = qgram_index_build(c->dictionary, c->dict_size, QGRAM_LENGTH);
+    }
+    c->decoded = NULL;
+    if (options->backend == SEARCH_LINEAR) {
+        c->decoded = utf8_words_decode(c->dictionary, c->dict_size);
+    }
+    return c;
+}
+
+/**
+ * @brief Frees the memory held by a corrector, dictionary included.
+ * 
+ * @param c Pointer to the corrector.
+ */
+void corrector_free(corrector *c) {
+    utf8_words_free(c->decoded);
+    qgram_index_free(c->qgrams);
+    dawg_compact_free(c->automaton);
+    bloom_filter_free(c->filter);
+    word_set_free(c->members);
+    free_dictionary(c->dictionary, c->dict_size);
+    free(c);
+}
+
+/**
+ * @brief Allocates the scratch memory a thread needs to correct text with a corrector.
+ * 
+ * @param scratch Scratch memory to initialize.
+ * @param c Pointer to the corrector.
+ */
+void correction_scratch_init(correction_scratch *scratch, const corrector *c) {
+    scratch->context = ed_context_create();
+    scratch->scratch = c->qgrams ? qgram_scratch_create(c->qgrams) : NULL;
+    scratch->table = NULL;
+    scratch->collect_stats = (c->stats != STATS_OFF);
+    memset(&scratch->stats, 0, sizeof(correction_stats));
+}
+
+/**
+ * @brief Adds the statistics of a thread to a total.
+ * 
+ * @param total Statistics the thread's ones are added to.
+ * @param scratch Scratch memory of the thread.
+ */
+void correction_stats_add(correction_stats *total, const correction_scratch *scratch) {
+    const correction_stats *s = &scratch->stats;
+    total->tokens += s->tokens;
+    total->hits += s->hits;
+    total->bloom_rejections += s->bloom_rejections;
+    total->searches += s->searches;
+    total->corrections += s->corrections;
+    total->candidates += s->candidates;
+    total->cells += s->cells + scratch->context->cells_computed;
+    total->tokenize_ns += s->tokenize_ns;
+    total->membership_ns += s->membership_ns;
+    total->search_ns += s->search_ns;
+    total->output_ns += s->output_ns;
+}
+
+/**
+ * @brief Prints the statistics of a correction run.
+ * 
+ * @param stats Statistics to print.
+ * @param format Format of the output; nothing is printed with `STATS_OFF`.
+ * @param out Stream the statistics are written to.
+ */
+void print_stats(const correction_stats *stats, stats_format format, FILE *out) {
+    if (format == STATS_JSON) {
+        fprintf(out, "{\"tokens\": %lld, \"dictionary_hits\": %lld, \"bloom_rejections\": %lld, "
+                     "\"searches\": %lld, \"corrections\": %lld, \"candidates\": %lld, \"dp_cells\": %lld, "
+                     "\"ns\": {\"tokenize\": %lld, \"membership\": %lld, \"search\": %lld, \"output\": %lld}}\n",
+                stats->tokens, stats->hits, stats->bloom_rejections, stats->searches, stats->corrections,
+                stats->candidates, stats->cells, stats->tokenize_ns, stats->membership_ns, stats->search_ns,
+                stats->output_ns);
+    } else if (format == STATS_TEXT) {
+        fprintf(out, "Tokens:            %lld\n", stats->tokens);
+        fprintf(out, "Dictionary hits:   %lld\n", stats->hits);
+        fprintf(out, "Bloom rejections:  %lld\n", stats->bloom_rejections);
+        fprintf(out, "Searches:          %lld (%lld corrected)\n", stats->searches, stats->corrections);
+        fprintf(out, "Candidates:        %lld\n", stats->candidates);
+        fprintf(out, "DP cells:          %lld\n", stats->cells);
+        fprintf(out, "Tokenize:          %.3f ms\n", (double)stats->tokenize_ns / 1e6);
+        fprintf(out, "Membership:        %.3f ms\n", (double)stats->membership_ns / 1e6);
+        fprintf(out, "Search:            %.3f ms\n", (double)stats->search_ns / 1e6);
+        fprintf(out, "Output:            %.3f ms\n", (double)stats->output_ns / 1e6);
+    }
+}
+
+/**
+ * @brief Frees the scratch memory of a thread.
+ * 
+ * @param scratch Scratch memory to free.
+ */
+void correction_scratch_free(correction_scratch *scratch) {
+    qgram_scratch_free(scratch->scratch);
+    ed_context_free(scratch->context);
+}
+
+/**
+ * @brief Orders strings through pointers to them, as `strcmp` does.
+ * 
+ * @param s1 Pointer to the first string pointer.
+ * @param s2 Pointer to the second string pointer.
+ * @return A negative, zero or positive value as the first string sorts before, with or after the second.
+ */
+static int compare_strings(const void *s1, const void *s2) {
+    return strcmp(*(char *const *)s1, *(char *const *)s2);
+}
+
+/**
+ * @brief Looks up a word in a correction table.
+ * 
+ * @param table Pointer to the table.
+ * @param word Word to look up.
+ * @return The position of the word in the table, or -1 if it is not there.
+ */
+int correction_table_find(const correction_table *table, const char *word) {
+    char **found = bsearch(&word, table->words, (size_t)table->count, sizeof(char *), compare_strings);
+    return found ? (int)(found - table->words) : -1;
+}
+
+/**
+ * @brief Corrects one line of text.
+ * 
+ * Each word is stripped of punctuation and looked up in the dictionary; words not found are
+ * replaced with the closest dictionary word within the threshold, if any. Every word is
+ * appended to `out` followed by a space, and the line by a newline. Words of the correction
+ * table of the scratch, if any, take their correction from it. Words of `MAX_WORD_LENGTH`
+ * bytes or more, longer than any dictionary word, are written unchanged. When the scratch
+ * collects statistics, the time between stages is read from the monotonic clock; otherwise
+ * the clock is never read.
+ * 
+ * @param c Pointer to the corrector.
+ * @param scratch Scratch memory of the calling thread.
+ * @param line Line to correct, as read by `fgets`; it is modified.
+ * @param out Buffer the corrected line is appended to.
+ * @param verbose Whether to print each word and its correction on the standard output.
+ */
+void correct_line(const corrector *c, correction_scratch *scratch, char *line, text_buffer *out, int verbose) {
+    correction_stats *stats = scratch->collect_stats ? &scratch->stats : NULL;
+    long long time = stats ? now_ns() : 0;
+    long long next_time;
+
+    char *save;
+    char *word = strtok_r(line, " \t\n", &save);
+    while (word != NULL) {
+        if (strlen(word) >= MAX_WORD_LENGTH) {
+            // Too long for the word buffers: the word is written as it is
+            if (verbose) printf("%s\n", word);
+            text_buffer_append(out, word);
+            text_buffer_append(out, " ");
+            if (stats) stats->tokens++;
+            word = strtok_r(NULL, " \t\n", &save);
+            continue;
+        }
+        char original_word[MAX_WORD_LENGTH];
+        strcpy(original_word, word);
+        char word_no_punct[MAX_WORD_LENGTH];
+        strcpy(word_no_punct, word);
+        remove_punctuation(word_no_punct);
+        if (stats) {
+            next_time = now_ns();
+            stats->tokenize_ns += next_time - time;
+            time = next_time;
+            stats->tokens++;
+        }
+
+        // Check if the word is in the dictionary, case insensitive
+        unsigned long long hash = word_set_hash(word_no_punct);
+        int in_dictionary = 0;
+        if (!c->filter || bloom_filter_may_contain(c->filter, hash)) {
+            in_dictionary = word_set_contains(c->members, word_no_punct, hash);
+        } else if (stats) {
+            stats->bloom_rejections++;
+        }
+        if (stats) {
+            next_time = now_ns();
+            stats->membership_ns += next_time - time;
+            time = next_time;
+            stats->hits += in_dictionary;
+        }
+
+        // If the word is not in the dictionary, correct it
+        char *closest_word = NULL;
+        if (!in_dictionary) {
+            long long calls = scratch->context->calls;
+            int entry = scratch->table ? correction_table_find(scratch->table, word_no_punct) : -1;
+            if (entry >= 0) {
+                closest_word = scratch->table->corrections[entry];
+            } else if (c->automaton) {
+                closest_word = find_closest_word_automaton(word_no_punct, c->automaton, c->edit_distance_threshold,
+                                                           scratch->automaton_word);
+            } else if (c->qgrams) {
+                int id = qgram_index_find_closest(c->qgrams, word_no_punct, c->edit_distance_threshold,
+                                                  scratch->scratch, scratch->context, NULL);
+                closest_word = (id >= 0) ? c->dictionary[id] : NULL;
+            } else {
+                closest_word = find_closest_word(word_no_punct, c->dictionary, c->dict_size, c->decoded,
+                                                 c->edit_distance_threshold, scratch->context);
+            }
+            if (stats) {
+                next_time = now_ns();
+                stats->search_ns += next_time - time;
+                time = next_time;
+                stats->searches++;
+                stats->corrections += (closest_word != NULL);
+                stats->candidates += scratch->context->calls - calls;
+            }
+        }
+
+        // If an alternative word is found, replace it
+        if (closest_word) {
+            if (verbose) printf("%s -> %s\n", original_word, closest_word);
+            text_buffer_append(out, closest_word);
+        } else {
+            if (verbose) printf("%s\n", original_word);
+            text_buffer_append(out, original_word);
+        }
+        text_buffer_append(out, " ");
+        if (stats) {
+            next_time = now_ns();
+            stats->output_ns += next_time - time;
+            time = next_time;
+        }
+
+        word = strtok_r(NULL, " \t\n", &save);
+    }
+    text_buffer_append(out, "\n");
+}
+
+/**
+ * @brief Searches in one batch the corrections of the misspelled words of a text.
+ * 
+ * The lines are scanned to collect the words missing from the dictionary, which are handed
+ * together to `find_closest_words`; the distinct words and their corrections are kept sorted
+ * for `correct_line`. The search is charged to the statistics of the scratch.
+ * 
+ * @param c Pointer to the corrector.
+ * @param scratch Scratch memory of the calling thread.
+ * @param lines Lines of the text, as read by `fgets`; they are not modified.
+ * @param nlines Number of lines.
+ * @param num_threads Number of threads of the search.
+ * @param table Output table.
+ */
+void correction_table_build(const corrector *c, correction_scratch *scratch, char **lines, int nlines,
+                            int num_threads, correction_table *table) {
+    char **words = NULL;
+    int nwords = 0, capacity = 0;
+    char line_text[MAXLEN];
+    for (int l = 0; l < nlines; ++l) {
+        strcpy(line_text, lines[l]);
+        char *save;
+        char *word = strtok_r(line_text, " \t\n", &save);
+        while (word != NULL) {
+            if (strlen(word) >= MAX_WORD_LENGTH) { // Written as it is by `correct_line`
+                word = strtok_r(NULL, " \t\n", &save);
+                continue;
+            }
+            char word_no_punct[MAX_WORD_LENGTH];
+            strcpy(word_no_punct, word);
+            remove_punctuation(word_no_punct);
+            unsigned long long hash = word_set_hash(word_no_punct);
+            if ((!c->filter || bloom_filter_may_contain(c->filter, hash)) &&
+                word_set_contains(c->members, word_no_punct, hash)) {
+                word = strtok_r(NULL, " \t\n", &save);
+                continue;
+            }
+            if (nwords == capacity) {
+                capacity = capacity ? 2 * capacity : 256;
+                char **temp = realloc(words, (size_t)capacity * sizeof(char *));
+                if (!temp) {
+                    perror("Memory allocation error");
+                    exit(EXIT_FAILURE);
+                }
+                words = temp;
+            }
+            words[nwords] = malloc(strlen(word_no_punct) + 1);
+            if (!words[nwords]) {
+                perror("Memory allocation error");
+                exit(EXIT_FAILURE);
+            }
+            strcpy(words[nwords++], word_no_punct);
+            word = strtok_r(NULL, " \t\n", &save);
+        }
+    }
+
+    long long time = scratch->collect_stats ? now_ns() : 0;
+    long long candidates, cells;
+    char **corrections = malloc(((size_t)nwords + 1) * sizeof(char *));
+    if (!corrections) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    int distinct = find_closest_words(words, nwords, c->dictionary, c->dict_size, c->decoded,
+                                      c->edit_distance_threshold, num_threads, corrections, &candidates, &cells);
+    if (scratch->collect_stats) {
+        scratch->stats.search_ns += now_ns() - time;
+        scratch->stats.candidates += candidates;
+        scratch->stats.cells += cells;
+    }
+
+    // Keep one entry per distinct word, sorted for the lookups
+    table->words = malloc(((size_t)distinct + 1) * sizeof(char *));
+    table->corrections = malloc(((size_t)distinct + 1) * sizeof(char *));
+    if (!table->words || !table->corrections) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    char **sorted = malloc(((size_t)nwords + 1) * sizeof(char *));
+    if (!sorted) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(sorted, words, (size_t)nwords * sizeof(char *));
+    qsort(sorted, (size_t)nwords, sizeof(char *), compare_strings);
+    table->count = 0;
+    for (int w = 0; w < nwords; ++w) {
+        if (table->count > 0 && strcmp(sorted[w], table->words[table->count - 1]) == 0) continue;
+        table->words[table->count++] = sorted[w];
+    }
+    // Every copy of a word has the same correction: take the one of any copy
+    for (int w = 0; w < nwords; ++w) {
+        int entry = correction_table_find(table, words[w]);
+        if (table->words[entry] == words[w]) {
+            table->corrections[entry] = corrections[w];
+        } else {
+            free(words[w]);
+        }
+    }
+
+    free(sorted);
+    free(corrections);
+    free(words);
+}
+
+/**
+ * @brief Frees the memory held by a correction table.
+ * 
+ * @param table Pointer to the table.
+ */
+void correction_table_free(correction_table *table) {
+    for (int w = 0; w < table->count; ++w) {
+        free(table->words[w]);
+    }
+    free(table->words);
+    free(table->corrections);
+}
+
+/**
+ * @brief Corrects the text using the provided dictionary.
+ * 
+ * This function reads a text file, processes each word by removing punctuation, checks if the
+ * word is in the dictionary, and if not, replaces it with the closest word from the dictionary
+ * that is within the edit distance threshold. The corrected text is then written to an output file.
+ * With `SEARCH_LINEAR` the lines of the text are kept in memory: the misspelled words are first
+ * collected and searched in one batch by `find_closest_words`, on `num_threads` threads, then
+ * the lines are corrected with the corrections found. The text is read once, so it need not be
+ * seekable.
+ * With `SEARCH_AUTOMATON` the closest word is searched in the minimal automaton of the
+ * dictionary; among equally close words the first in byte order is chosen, while the linear
+ * search chooses the first in dictionary order, and distances are counted in bytes, which
+ * differs from the other searches on non-ASCII words. With `SEARCH_QGRAM` only the
+ * candidates of a q-gram index are compared, and the result is the same as the linear search.
+ * Membership is checked in a case-insensitive hash set of the dictionary; with the `bloom`
+ * option a blocked Bloom filter answers first, and the words it rejects go straight to the
+ * correction without probing the set.
+ * 
+ * @param dictionary_file Path to the dictionary file.
+ * @param text_file Path to the text file to be corrected.
+ * @param options Correction options.
+ * @param num_threads Number of threads of the batched linear search.
+ */
+void correct_text(const char *dictionary_file, const char *text_file, const correction_options *options,
+                  int num_threads) {
+    corrector *c = corrector_create(dictionary_file, options, stdout);
+    correction_scratch scratch;
+    correction_scratch_init(&scratch, c);
 
     // Open the text file to correct
     FILE *text = fopen(text_file, "r");
@@ -119,67 +761,577 @@ void correct_text(const char *dictionary_file, const char *text_file) {
 
     printf("Text file opened successfully.\n");
 
+    char line_text[MAXLEN];
+    char **lines = NULL;
+    int nlines = 0, capacity = 0;
+    correction_table table = {NULL, NULL, 0};
+    if (options->backend == SEARCH_LINEAR) {
+        while (fgets(line_text, sizeof(line_text), text)) {
+            if (nlines == capacity) {
+                capacity = capacity ? 2 * capacity : 256;
+                char **temp = realloc(lines, (size_t)capacity * sizeof(char *));
+                if (!temp) {
+                    perror("Memory allocation error");
+                    exit(EXIT_FAILURE);
+                }
+                lines = temp;
+            }
+            lines[nlines] = malloc(strlen(line_text) + 1);
+            if (!lines[nlines]) {
+                perror("Memory allocation error");
+                exit(EXIT_FAILURE);
+            }
+            strcpy(lines[nlines++], line_text);
+        }
+        correction_table_build(c, &scratch, lines, nlines, num_threads, &table);
+        scratch.table = &table;
+    }
+
     FILE *output = fopen("corrected_text.txt", "w");
     if (!output) {
         perror("Error opening output file");
         exit(EXIT_FAILURE);
     }
 
-    char line_text[MAXLEN];
-
-    // Define the edit distance threshold
-    int edit_distance_threshold = 2; // Can be adjusted as needed
+    text_buffer corrected = {NULL, 0, 0};
 
     // Correct each line of the text
+    if (options->backend == SEARCH_LINEAR) {
+        for (int l = 0; l < nlines; ++l) {
+            corrected.length = 0;
+            correct_line(c, &scratch, lines[l], &corrected, 1);
+            fwrite(corrected.data, 1, corrected.length, output);
+            free(lines[l]);
+        }
+        free(lines);
+    } else {
+        while (fgets(line_text, sizeof(line_text), text)) {
+            corrected.length = 0;
+            correct_line(c, &scratch, line_text, &corrected, 1);
+            fwrite(corrected.data, 1, corrected.length, output);
+        }
+    }
+
+    correction_stats total;
+    memset(&total, 0, sizeof(total));
+    correction_stats_add(&total, &scratch);
+    print_stats(&total, options->stats, stdout);
+
+    // Free the memory allocated for the dictionary
+    free(corrected.data);
+    correction_table_free(&table);
+    correction_scratch_free(&scratch);
+    corrector_free(c);
+
+    fclose(text);
+    fclose(output);
+}
+
+/**
+ * @brief Compares the linear, the automaton and the q-gram search on the misspelled words of a text.
+ * 
+ * This function collects the words of the text that are not in the dictionary, looks each
+ * of them up with `find_closest_word`, `find_closest_words`, `find_closest_word_automaton`
+ * and the q-gram index, and prints the time taken by each search and whether they found
+ * corrections at the same distance, along with the candidates verified per word by the
+ * q-gram search. It also compares the memory held by the pointer array of the dictionary with the memory of
+ * its compact automaton.
+ * 
+ * @param dictionary_file Path to the dictionary file.
+ * @param text_file Path to the text file whose misspelled words are searched.
+ */
+void benchmark_search(const char *dictionary_file, const char *text_file) {
+    int dict_size = 0;
+    char **dictionary = load_dictionary(dictionary_file, &dict_size, stdout);
+    int edit_distance_threshold = 2;
+    ed_context *context = ed_context_create();
+
+    clock_t clock_time = clock();
+    dawg *builder = dawg_build(dictionary, dict_size);
+    dawg_compact *automaton = dawg_compact_build(builder);
+    clock_time = clock() - clock_time;
+    printf("Dictionary automaton built in %.3f s: %d states, %d transitions.\n",
+           (double)clock_time / CLOCKS_PER_SEC, builder->node_count, builder->edge_count);
+    dawg_free(builder);
+
+    // Memory of the dictionary as an array of separately allocated words
+    size_t word_bytes = 0;
+    for (int i = 0; i < dict_size; ++i) {
+        word_bytes += strlen(dictionary[i]) + 1;
+    }
+    size_t pointer_bytes = (size_t)dict_size * sizeof(char *);
+    printf("Pointer array:      %zu bytes (%zu of words, %zu of pointers, plus the allocator overhead of %d allocations)\n",
+           word_bytes + pointer_bytes, word_bytes, pointer_bytes, dict_size + 1);
+    printf("Compact automaton:  %zu bytes (%.1f%% of the pointer array)\n", dawg_compact_memory(automaton),
+           100.0 * (double)dawg_compact_memory(automaton) / (double)(word_bytes + pointer_bytes));
+
+    FILE *text = fopen(text_file, "r");
+    if (!text) {
+        perror("Error opening text file to correct");
+        exit(EXIT_FAILURE);
+    }
+
+    // Collect the misspelled words
+    char **words = NULL;
+    int nwords = 0;
+    char line_text[MAXLEN];
     while (fgets(line_text, sizeof(line_text), text)) {
         char *word = strtok(line_text, " \t\n");
         while (word != NULL) {
-            char original_word[MAX_WORD_LENGTH];
-            strcpy(original_word, word);
+            if (strlen(word) >= MAX_WORD_LENGTH) { // Never corrected
+                word = strtok(NULL, " \t\n");
+                continue;
+            }
             char word_no_punct[MAX_WORD_LENGTH];
             strcpy(word_no_punct, word);
             remove_punctuation(word_no_punct);
 
             int in_dictionary = 0;
-
-            // Check if the word is in the dictionary
-            for (int i = 0; i < dict_size; ++i) {
-                if (strcasecmp(word_no_punct, dictionary[i]) == 0) { // Case insensitive comparison
-                    in_dictionary = 1;
-                    break;
+            for (int i = 0; i < dict_size && !in_dictionary; ++i) {
+                in_dictionary = (strcasecmp(word_no_punct, dictionary[i]) == 0);
+            }
+            if (!in_dictionary) {
+                char **temp = realloc(words, (size_t)(nwords + 1) * sizeof(char *));
+                if (!temp) {
+                    perror("Memory allocation error");
+                    exit(EXIT_FAILURE);
                 }
+                words = temp;
+                words[nwords] = malloc(strlen(word_no_punct) + 1);
+                if (!words[nwords]) {
+                    perror("Memory allocation error");
+                    exit(EXIT_FAILURE);
+                }
+                strcpy(words[nwords++], word_no_punct);
             }
+            word = strtok(NULL, " \t\n");
+        }
+    }
+    fclose(text);
 
-            // If the word is not in the dictionary, correct it
-            if (!in_dictionary) {
-                char *closest_word = find_closest_word(word_no_punct, dictionary, dict_size, edit_distance_threshold);
-
-                // If an alternative word is found, replace it
-                if (closest_word) {
-                    printf("%s -> %s\n", original_word, closest_word);
-                    fprintf(output, "%s ", closest_word);
-                } else {
-                    printf("%s\n", original_word);
-                    fprintf(output, "%s ", original_word);
+    int *linear_distances = malloc((size_t)(nwords + 1) * sizeof(int));
+    if (!linear_distances) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    utf8_words *decoded = utf8_words_decode(dictionary, dict_size);
+    clock_time = clock();
+    for (int w = 0; w < nwords; ++w) {
+        char *closest = find_closest_word(words[w], dictionary, dict_size, decoded, edit_distance_threshold, context);
+        linear_distances[w] = closest ? edit_distance_dyn_ctx(context, words[w], closest) : -1;
+    }
+    clock_t linear_time = clock() - clock_time;
+
+    // Batched linear search, on one thread so that its time compares with the linear one
+    char **batch_closest = malloc((size_t)(nwords + 1) * sizeof(char *));
+    if (!batch_closest) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    clock_time = clock();
+    int distinct = find_closest_words(words, nwords, dictionary, dict_size, decoded, edit_distance_threshold, 1,
+                                      batch_closest, NULL, NULL);
+    clock_t batch_time = clock() - clock_time;
+    int batch_agreements = 0;
+    for (int w = 0; w < nwords; ++w) {
+        int distance = batch_closest[w] ? edit_distance_dyn_ctx(context, words[w], batch_closest[w]) : -1;
+        batch_agreements += (distance == linear_distances[w]);
+    }
+    free(batch_closest);
+
+    int agreements = 0;
+    char buffer[MAX_WORD_LENGTH];
+    clock_time = clock();
+    for (int w = 0; w < nwords; ++w) {
+        char *closest = find_closest_word_automaton(words[w], automaton, edit_distance_threshold, buffer);
+        int distance = closest ? edit_distance_dyn_ctx(context, words[w], closest) : -1;
+        agreements += (distance == linear_distances[w]);
+    }
+    clock_t automaton_time = clock() - clock_time;
+
+    clock_time = clock();
+    qgram_index *qgrams = qgram_index_build(dictionary, dict_size, QGRAM_LENGTH);
+    clock_t qgram_build_time = clock() - clock_time;
+    qgram_scratch *scratch = qgram_scratch_create(qgrams);
+    int qgram_agreements = 0;
+    clock_time = clock();
+    for (int w = 0; w < nwords; ++w) {
+        int distance;
+        qgram_index_find_closest(qgrams, words[w], edit_distance_threshold, scratch, context, &distance);
+        qgram_agreements += (distance == linear_distances[w]);
+    }
+    clock_t qgram_time = clock() - clock_time;
+
+    printf("Misspelled words searched: %d\n", nwords);
+    printf("Linear search:    %.3f s\n", (double)linear_time / CLOCKS_PER_SEC);
+    printf("Batched search:   %.3f s (%d distinct words)\n", (double)batch_time / CLOCKS_PER_SEC, distinct);
+    printf("Batched corrections at the same distance: %d/%d\n", batch_agreements, nwords);
+    printf("Automaton search: %.3f s\n", (double)automaton_time / CLOCKS_PER_SEC);
+    printf("Corrections at the same distance: %d/%d\n", agreements, nwords);
+    printf("Q-gram search:    %.3f s (index built in %.3f s, %.1f candidates per word)\n",
+           (double)qgram_time / CLOCKS_PER_SEC, (double)qgram_build_time / CLOCKS_PER_SEC,
+           nwords ? (double)scratch->candidates / nwords : 0.0);
+    printf("Q-gram corrections at the same distance: %d/%d\n", qgram_agreements, nwords);
+
+    for (int w = 0; w < nwords; ++w) {
+        free(words[w]);
+    }
+    free(words);
+    free(linear_distances);
+    utf8_words_free(decoded);
+    qgram_scratch_free(scratch);
+    qgram_index_free(qgrams);
+    ed_context_free(context);
+    dawg_compact_free(automaton);
+    free_dictionary(dictionary, dict_size);
+}
+
+/**
+ * @brief Computes the edit distance between the whole contents of two files.
+ * 
+ * This function is meant for document-scale comparisons: the two files are read into
+ * memory and compared with `edit_distance_wavefront`, and the distance is printed with the
+ * time it took.
+ * 
+ * @param file1 Path to the first file.
+ * @param file2 Path to the second file.
+ * @param num_threads Number of threads.
+ */
+void compare_files(const char *file1, const char *file2, int num_threads) {
+    const char *paths[2] = {file1, file2};
+    char *contents[2];
+
+    for (int f = 0; f < 2; ++f) {
+        FILE *in = fopen(paths[f], "rb");
+        if (!in) {
+            perror("Error opening file to compare");
+            exit(EXIT_FAILURE);
+        }
+        fseek(in, 0, SEEK_END);
+        long size = ftell(in);
+        fseek(in, 0, SEEK_SET);
+        contents[f] = malloc((size_t)(size > 0 ? size : 0) + 1);
+        if (!contents[f]) {
+            perror("Memory allocation error");
+            exit(EXIT_FAILURE);
+        }
+        size_t read = fread(contents[f], 1, (size_t)(size > 0 ? size : 0), in);
+        contents[f][read] = '\0';
+        fclose(in);
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int distance = edit_distance_wavefront(contents[0], contents[1], num_threads);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    printf("Edit distance: %d\n", distance);
+    printf("Computed with %d threads in %.3f s\n", num_threads,
+           (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9);
+
+    free(contents[0]);
+    free(contents[1]);
+}
+
+/**
+ * @brief Worker pool correcting the lines of a batch request in parallel.
+ * 
+ * The pool threads live as long as the server. For each batch the main thread publishes
+ * the lines and bumps `generation`; the workers take lines from the shared cursor and the
+ * last one to finish wakes the main thread, which writes the results in order.
+ */
+typedef struct {
+    const corrector *corrector;
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    char **lines;               // Lines of the current batch
+    text_buffer *results;       // Corrected lines of the current batch
+    int nlines;
+    int max_batch;              // Largest batch accepted from a client
+    int next_line;              // Next line to be taken by a worker
+    int pending;                // Lines not corrected yet
+    long generation;            // Number of batches published
+    int stopping;
+    correction_stats stats;     // Statistics of the workers that have exited
+} server_pool;
+
+/**
+ * @brief Body of a pool thread: corrects lines of each published batch.
+ * 
+ * Each line is cut into pieces of at most `MAXLEN - 1` characters, as `fgets` cuts the lines
+ * of a text file, so that the results are the same as in file mode.
+ * 
+ * @param arg Pointer to the `server_pool`.
+ * @return NULL.
+ */
+static void *server_worker_run(void *arg) {
+    server_pool *pool = arg;
+    correction_scratch scratch;
+    correction_scratch_init(&scratch, pool->corrector);
+    char *piece = malloc(MAXLEN);
+    if (!piece) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->generation == seen && !pool->stopping) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->stopping) break;
+        seen = pool->generation;
+
+        while (pool->next_line < pool->nlines) {
+            int i = pool->next_line++;
+            pthread_mutex_unlock(&pool->lock);
+
+            const char *line = pool->lines[i];
+            text_buffer *result = &pool->results[i];
+            result->length = 0;
+            do {
+                size_t n = strlen(line);
+                if (n > MAXLEN - 1) n = MAXLEN - 1;
+                memcpy(piece, line, n);
+                piece[n] = '\0';
+                line += n;
+                correct_line(pool->corrector, &scratch, piece, result, 0);
+            } while (*line);
+
+            pthread_mutex_lock(&pool->lock);
+            if (--pool->pending == 0) {
+                pthread_cond_signal(&pool->work_done);
+            }
+        }
+    }
+    correction_stats_add(&pool->stats, &scratch);
+    pthread_mutex_unlock(&pool->lock);
+
+    free(piece);
+    correction_scratch_free(&scratch);
+    return NULL;
+}
+
+/**
+ * @brief Answers the batch requests read from a stream until it ends.
+ * 
+ * A request is a line holding the number `n` of lines in the batch, followed by the `n`
+ * lines; the answer is the `n` corrected lines, exactly as file mode writes them to
+ * `corrected_text.txt`. A header that is not just a number is answered with an `ERROR`
+ * line, and so is a batch larger than the maximum of the pool, whose lines are then read
+ * and dropped so that they are not taken for headers. The buffers of the lines grow as the
+ * lines arrive. The latency of each request, from the end of its reading to the
+ * flush of its answer, is reported on the standard error.
+ * 
+ * @param pool Pointer to the worker pool.
+ * @param in Stream the requests are read from.
+ * @param out Stream the answers are written to.
+ * @param served Counter of the requests served, used to number them.
+ */
+static void serve_stream(server_pool *pool, FILE *in, FILE *out, long *served) {
+    char *header = NULL;
+    size_t header_size = 0;
+    char **lines = NULL;
+    size_t *sizes = NULL;
+    text_buffer *results = NULL;
+    int capacity = 0;
+
+    while (getline(&header, &header_size, in) >= 0) {
+        char *end;
+        long n = strtol(header, &end, 10);
+        int digits = (end != header);
+        if (*end == '\r') end++;
+        if (*end == '\n') end++;
+        if (!digits || *end != '\0' || n < 0) {
+            fprintf(out, "ERROR expected the number of lines of the batch\n");
+            fflush(out);
+            continue;
+        }
+        if (n > pool->max_batch) {
+            fprintf(out, "ERROR batch of %ld lines, the maximum is %d\n", n, pool->max_batch);
+            fflush(out);
+            long skipped = 0;
+            while (skipped < n && getline(&header, &header_size, in) >= 0) skipped++;
+            if (skipped < n) break; // The stream ended in the middle of the batch
+            continue;
+        }
+
+        int nlines = 0;
+        while (nlines < n) {
+            if (nlines == capacity) {
+                int grown = capacity ? 2 * capacity : 64;
+                if (grown > n) grown = (int)n;
+                lines = realloc(lines, (size_t)grown * sizeof(char *));
+                sizes = realloc(sizes, (size_t)grown * sizeof(size_t));
+                results = realloc(results, (size_t)grown * sizeof(text_buffer));
+                if (!lines || !sizes || !results) {
+                    perror("Memory allocation error");
+                    exit(EXIT_FAILURE);
                 }
-            } else {
-                printf("%s\n", original_word);
-                fprintf(output, "%s ", original_word);
+                for (int i = capacity; i < grown; ++i) {
+                    lines[i] = NULL;
+                    sizes[i] = 0;
+                    results[i] = (text_buffer){NULL, 0, 0};
+                }
+                capacity = grown;
             }
+            if (getline(&lines[nlines], &sizes[nlines], in) < 0) break;
+            nlines++;
+        }
 
-            word = strtok(NULL, " \t\n");
+        struct timespec start, stop;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->lines = lines;
+        pool->results = results;
+        pool->nlines = nlines;
+        pool->next_line = 0;
+        pool->pending = nlines;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->work_ready);
+        while (pool->pending > 0) {
+            pthread_cond_wait(&pool->work_done, &pool->lock);
         }
-        fprintf(output, "\n");
+        pthread_mutex_unlock(&pool->lock);
+
+        for (int i = 0; i < nlines; ++i) {
+            fwrite(results[i].data, 1, results[i].length, out);
+        }
+        fflush(out);
+
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        (*served)++;
+        fprintf(stderr, "Request %ld: %d lines in %.3f ms\n", *served, nlines,
+                (double)(stop.tv_sec - start.tv_sec) * 1e3 + (double)(stop.tv_nsec - start.tv_nsec) / 1e6);
+
+        if (nlines < n) break; // The stream ended in the middle of the batch
     }
 
-    // Free the memory allocated for the dictionary
-    for (int i = 0; i < dict_size; ++i) {
-        free(dictionary[i]);
+    for (int i = 0; i < capacity; ++i) {
+        free(lines[i]);
+        free(results[i].data);
     }
-    free(dictionary);
+    free(lines);
+    free(sizes);
+    free(results);
+    free(header);
+}
 
-    fclose(text);
-    fclose(output);
+/**
+ * @brief Runs the spell-checking server.
+ * 
+ * The dictionary and the search structures are built once, then batch requests are answered
+ * by a pool of `num_threads` workers, on the standard input and output or, if `socket_path`
+ * is given, on the connections accepted one at a time on a Unix domain socket. Progress
+ * messages go to the standard error, so that the standard output only carries answers.
+ * When `accept` runs out of descriptors or memory, the server waits before trying again,
+ * twice as long after each failure up to a second; any other error stops it.
+ * 
+ * @param dictionary_file Path to the dictionary file.
+ * @param options Correction options.
+ * @param num_threads Number of worker threads.
+ * @param socket_path Path of the Unix domain socket, or NULL to use the standard streams.
+ * @param max_batch Maximum number of lines of a batch request.
+ * @return Exit status of the program.
+ */
+int serve_requests(const char *dictionary_file, const correction_options *options, int num_threads,
+                   const char *socket_path, int max_batch) {
+    corrector *c = corrector_create(dictionary_file, options, stderr);
+
+    server_pool pool;
+    pool.corrector = c;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.work_ready, NULL);
+    pthread_cond_init(&pool.work_done, NULL);
+    pool.nlines = pool.next_line = pool.pending = 0;
+    pool.max_batch = max_batch;
+    pool.generation = 0;
+    pool.stopping = 0;
+    memset(&pool.stats, 0, sizeof(pool.stats));
+
+    if (num_threads < 1) num_threads = 1;
+    pthread_t *threads = malloc((size_t)num_threads * sizeof(pthread_t));
+    if (!threads) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < num_threads; ++t) {
+        if (pthread_create(&threads[t], NULL, server_worker_run, &pool) != 0) {
+            perror("Error creating worker thread");
+            exit(EXIT_FAILURE);
+        }
+    }
+    fprintf(stderr, "Server ready with %d worker threads.\n", num_threads);
+
+    long served = 0;
+    int status = EXIT_SUCCESS;
+    if (!socket_path) {
+        serve_stream(&pool, stdin, stdout, &served);
+    } else {
+        signal(SIGPIPE, SIG_IGN); // A client leaving early must not stop the server
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0 || strlen(socket_path) >= sizeof(address.sun_path)) {
+            perror("Error creating socket");
+            status = EXIT_FAILURE;
+        } else {
+            strcpy(address.sun_path, socket_path);
+            unlink(socket_path);
+            if (bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, 16) != 0) {
+                perror("Error binding socket");
+                status = EXIT_FAILURE;
+            }
+            long backoff_ms = 0;
+            while (status == EXIT_SUCCESS) {
+                int connection = accept(listener, NULL, NULL);
+                if (connection < 0) {
+                    int error = errno;
+                    if (error == EINTR || error == ECONNABORTED) continue;
+                    perror("Error accepting connection");
+                    if (error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM) {
+                        backoff_ms = backoff_ms ? (backoff_ms < 500 ? 2 * backoff_ms : 1000) : 10;
+                        struct timespec delay = {backoff_ms / 1000, (backoff_ms % 1000) * 1000000};
+                        nanosleep(&delay, NULL);
+                    } else {
+                        status = EXIT_FAILURE;
+                    }
+                    continue;
+                }
+                backoff_ms = 0;
+                FILE *in = fdopen(connection, "r");
+                FILE *out = fdopen(dup(connection), "w");
+                if (in && out) {
+                    serve_stream(&pool, in, out, &served);
+                }
+                if (out) fclose(out);
+                if (in) fclose(in);
+            }
+            close(listener);
+        }
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.stopping = 1;
+    pthread_cond_broadcast(&pool.work_ready);
+    pthread_mutex_unlock(&pool.lock);
+    for (int t = 0; t < num_threads; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    print_stats(&pool.stats, options->stats, stderr);
+
+    free(threads);
+    pthread_cond_destroy(&pool.work_done);
+    pthread_cond_destroy(&pool.work_ready);
+    pthread_mutex_destroy(&pool.lock);
+    corrector_free(c);
+    return status;
 }
 
 /**
@@ -187,26 +1339,124 @@ void correct_text(const char *dictionary_file, const char *text_file) {
  * 
  * This function parses command-line arguments to obtain the paths for the dictionary file and the
  * text file to be corrected. It then calls the `correct_text` function to perform the correction.
+ * When the first argument is `diff`, the two following files are compared line by line instead
+ * and a unified-style edit script is printed; the exit status is then 0 if the files are equal,
+ * 1 if they differ and 2 on error, as for the `diff` utility. When the first argument is `join`,
+ * every pair of strings from the two word lists within the given edit distance is printed. When
+ * it is `bench`, the linear, automaton and q-gram dictionary searches are timed on the misspelled
+ * words of the text. When it is `compare`, the edit distance between the whole contents of the
+ * two files is computed with the multi-threaded wavefront kernel. When it is `serve`, the
+ * dictionary is loaded once and batch requests are answered until the input ends (see
+ * `serve_requests`). The option `--search=linear` (default), `--search=automaton` or
+ * `--search=qgram` selects the dictionary search used by the correction, and `--bloom`,
+ * `--bloom-fpr=<rate>` (default 0.01) or `--bloom-bytes=<size>` put a Bloom filter in front
+ * of the dictionary membership check. `--stats` or `--stats=json` print the counters and
+ * timers of the correction stages at the end of the run.
  * 
  * @param argc Number of command-line arguments.
  * @param argv Array of command-line arguments.
  * @return Exit status of the program.
  */
 int main(int argc, char *argv[]) {
-    if (argc != 3) {
-        printf("Usage: %s <dictionary_file> <text_file_to_correct>\n", argv[0]);
+    if (argc == 4 && strcmp(argv[1], "diff") == 0) {
+        int distance = line_diff_files(argv[2], argv[3], stdout);
+        if (distance < 0) {
+            return 2;
+        }
+        return distance == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if ((argc == 5 || argc == 6) && strcmp(argv[1], "join") == 0) {
+        int max_distance = atoi(argv[4]);
+        int num_threads = (argc == 6) ? atoi(argv[5]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        long pairs = similarity_join_files(argv[2], argv[3], max_distance, num_threads, stdout);
+        if (pairs < 0) {
+            return EXIT_FAILURE;
+        }
+        fprintf(stderr, "Similarity join found %ld pairs.\n", pairs);
+        return EXIT_SUCCESS;
+    }
+
+    if ((argc == 4 || argc == 5) && strcmp(argv[1], "compare") == 0) {
+        int num_threads = (argc == 5) ? atoi(argv[4]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        compare_files(argv[2], argv[3], num_threads);
+        return EXIT_SUCCESS;
+    }
+
+    if (argc == 4 && strcmp(argv[1], "bench") == 0) {
+        benchmark_search(argv[2], argv[3]);
+        return EXIT_SUCCESS;
+    }
+
+    correction_options options = {SEARCH_LINEAR, STATS_OFF, 0, 0.01, 0};
+    int serve = (argc > 1 && strcmp(argv[1], "serve") == 0);
+    int num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *socket_path = NULL;
+    int max_batch = SERVER_MAX_BATCH;
+    int arg = serve ? 2 : 1;
+    while (arg < argc && strncmp(argv[arg], "--", 2) == 0) {
+        if (strcmp(argv[arg], "--search=linear") == 0) {
+            options.backend = SEARCH_LINEAR;
+        } else if (strcmp(argv[arg], "--search=automaton") == 0) {
+            options.backend = SEARCH_AUTOMATON;
+        } else if (strcmp(argv[arg], "--search=qgram") == 0) {
+            options.backend = SEARCH_QGRAM;
+        } else if (strcmp(argv[arg], "--stats") == 0) {
+            options.stats = STATS_TEXT;
+        } else if (strcmp(argv[arg], "--stats=json") == 0) {
+            options.stats = STATS_JSON;
+        } else if (strcmp(argv[arg], "--bloom") == 0) {
+            options.bloom = 1;
+        } else if (strncmp(argv[arg], "--bloom-fpr=", 12) == 0) {
+            options.bloom = 1;
+            options.bloom_false_positive_rate = atof(argv[arg] + 12);
+        } else if (strncmp(argv[arg], "--bloom-bytes=", 14) == 0) {
+            options.bloom = 1;
+            options.bloom_bytes = (size_t)atol(argv[arg] + 14);
+        } else if (strncmp(argv[arg], "--threads=", 10) == 0) {
+            num_threads = atoi(argv[arg] + 10);
+        } else if (serve && strncmp(argv[arg], "--socket=", 9) == 0) {
+            socket_path = argv[arg] + 9;
+        } else if (serve && strncmp(argv[arg], "--max-batch=", 12) == 0) {
+            char *end;
+            long value = strtol(argv[arg] + 12, &end, 10);
+            if (end == argv[arg] + 12 || *end != '\0' || value < 1 || value > INT_MAX) {
+                printf("Invalid maximum batch size: %s\n", argv[arg] + 12);
+                return EXIT_FAILURE;
+            }
+            max_batch = (int)value;
+        } else {
+            printf("Unknown option: %s\n", argv[arg]);
+            return EXIT_FAILURE;
+        }
+        arg++;
+    }
+
+    if (serve && argc - arg == 1) {
+        return serve_requests(argv[arg], &options, num_threads, socket_path, max_batch);
+    }
+
+    if (serve || argc - arg != 2) {
+        printf("Usage: %s [--search=linear|automaton|qgram] [--stats[=json]] [--bloom] [--bloom-fpr=<rate>] [--bloom-bytes=<size>]\n"
+               "       [--threads=<n>] <dictionary_file> <text_file_to_correct>\n", argv[0]);
+        printf("       %s diff <file1> <file2>\n", argv[0]);
+        printf("       %s join <list1> <list2> <max_distance> [threads]\n", argv[0]);
+        printf("       %s bench <dictionary_file> <text_file>\n", argv[0]);
+        printf("       %s compare <file1> <file2> [threads]\n", argv[0]);
+        printf("       %s serve [correction options] [--threads=<n>] [--socket=<path>] [--max-batch=<n>]\n"
+               "       <dictionary_file>\n", argv[0]);
         return EXIT_FAILURE;
     }
 
     char dictionary_path[MAXLEN];
     char text_path[MAXLEN];
-    sprintf(dictionary_path, "%s", argv[1]);
-    sprintf(text_path, "%s", argv[2]);
+    sprintf(dictionary_path, "%s", argv[arg]);
+    sprintf(text_path, "%s", argv[arg + 1]);
 
     printf("Dictionary path: %s\n", dictionary_path);
     printf("Text file to correct: %s\n", text_path);
 
-    correct_text(dictionary_path, text_path);
+    correct_text(dictionary_path, text_path, &options, num_threads);
 
     return EXIT_SUCCESS;
 }
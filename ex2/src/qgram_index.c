@@ -0,0 +1,359 @@
+#include "qgram_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief A q-gram occurrence tagged with its key, sorted while the index is built.
+ */
+typedef struct {
+    unsigned long long key;
+    int id;
+    int position;
+} qgram_entry;
+
+/**
+ * @brief Hashes a q-gram of code points into a 64-bit key with FNV-1a.
+ *
+ * @param s Pointer to the first code point of the q-gram.
+ * @param q Length of the q-gram.
+ * @return The key of the q-gram.
+ */
+static unsigned long long qgram_key(const unsigned int *s, int q) {
+    unsigned long long key = 14695981039346656037ULL;
+    for (int i = 0; i < q; ++i) {
+        key ^= s[i];
+        key *= 1099511628211ULL;
+    }
+    return key;
+}
+
+/**
+ * @brief Returns the first slot probed for a key.
+ *
+ * @param key Key of the q-gram.
+ * @param capacity Number of slots, a power of two.
+ * @return The slot.
+ */
+static size_t qgram_slot_of(unsigned long long key, size_t capacity) {
+    return (size_t)((key * 0x9e3779b97f4a7c15ULL) >> 32) & (capacity - 1);
+}
+
+/**
+ * @brief Orders q-gram entries by key, then by id, then by position.
+ *
+ * @param e1 Pointer to the first entry.
+ * @param e2 Pointer to the second entry.
+ * @return A negative, zero or positive value as the first entry sorts before, with or after the second.
+ */
+static int compare_entries(const void *e1, const void *e2) {
+    const qgram_entry *a = e1;
+    const qgram_entry *b = e2;
+    if (a->key != b->key) return (a->key < b->key) ? -1 : 1;
+    if (a->id != b->id) return (a->id > b->id) - (a->id < b->id);
+    return (a->position > b->position) - (a->position < b->position);
+}
+
+/**
+ * @brief Looks up the postings list of a q-gram.
+ *
+ * @param index Pointer to the index.
+ * @param key Key of the q-gram.
+ * @return The slot of the key, or NULL if no word contains the q-gram.
+ */
+static const qgram_slot *find_postings(const qgram_index *index, unsigned long long key) {
+    size_t slot = qgram_slot_of(key, index->capacity);
+    while (index->table[slot].count > 0) {
+        if (index->table[slot].key == key) {
+            return &index->table[slot];
+        }
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Builds the positional q-gram index of a list of words.
+ *
+ * This function decodes the non-ASCII words, lists every q-gram occurrence, sorts the
+ * occurrences by q-gram so that the postings of each q-gram form a run, and maps each q-gram to its run in an open-addressing
+ * table. Words are also listed by length for the lengths the count filter cannot handle.
+ *
+ * @param words Array of pointers to the words.
+ * @param nwords Number of words.
+ * @param q Length of the q-grams.
+ * @return Pointer to the new index, or NULL if `q` is not supported.
+ */
+qgram_index *qgram_index_build(char **words, int nwords, int q) {
+    if (q < 1 || q > QGRAM_MAX_Q) {
+        return NULL;
+    }
+
+    qgram_index *index = malloc(sizeof(qgram_index));
+    if (!index) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    index->words = words;
+    index->nwords = nwords;
+    index->q = q;
+    index->decoded = utf8_words_decode(words, nwords);
+    index->lengths = index->decoded->lengths;
+    index->max_length = index->decoded->max_length;
+
+    size_t nentries = 0;
+    for (int id = 0; id < nwords; ++id) {
+        if (index->lengths[id] >= q) nentries += (size_t)(index->lengths[id] - q + 1);
+    }
+
+    // Counting sort of the ids by length
+    index->length_start = calloc((size_t)index->max_length + 2, sizeof(int));
+    index->by_length = malloc(((size_t)nwords + 1) * sizeof(int));
+    if (!index->length_start || !index->by_length) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    for (int id = 0; id < nwords; ++id) {
+        index->length_start[index->lengths[id] + 1]++;
+    }
+    for (int l = 0; l <= index->max_length; ++l) {
+        index->length_start[l + 1] += index->length_start[l];
+    }
+    int *fill = malloc(((size_t)index->max_length + 1) * sizeof(int));
+    if (!fill) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(fill, index->length_start, ((size_t)index->max_length + 1) * sizeof(int));
+    for (int id = 0; id < nwords; ++id) {
+        index->by_length[fill[index->lengths[id]]++] = id;
+    }
+    free(fill);
+
+    qgram_entry *entries = malloc((nentries + 1) * sizeof(qgram_entry));
+    index->postings = malloc((nentries + 1) * sizeof(qgram_posting));
+    unsigned int *buffer = malloc(((size_t)index->max_length + 1) * sizeof(unsigned int));
+    if (!entries || !index->postings || !buffer) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    size_t e = 0;
+    for (int id = 0; id < nwords; ++id) {
+        const unsigned int *codepoints = utf8_words_codepoints(index->decoded, words, id, buffer);
+        for (int position = 0; position + q <= index->lengths[id]; ++position) {
+            entries[e].key = qgram_key(codepoints + position, q);
+            entries[e].id = id;
+            entries[e].position = position;
+            e++;
+        }
+    }
+    free(buffer);
+    qsort(entries, nentries, sizeof(qgram_entry), compare_entries);
+
+    index->capacity = 16;
+    while (index->capacity < 2 * nentries) index->capacity <<= 1;
+    index->table = calloc(index->capacity, sizeof(qgram_slot));
+    if (!index->table) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t run = 0;
+    while (run < nentries) {
+        size_t end = run;
+        while (end < nentries && entries[end].key == entries[run].key) {
+            index->postings[end].id = entries[end].id;
+            index->postings[end].position = entries[end].position;
+            end++;
+        }
+        size_t slot = qgram_slot_of(entries[run].key, index->capacity);
+        while (index->table[slot].count > 0) slot = (slot + 1) & (index->capacity - 1);
+        index->table[slot].key = entries[run].key;
+        index->table[slot].start = (int)run;
+        index->table[slot].count = (int)(end - run);
+        run = end;
+    }
+
+    free(entries);
+    return index;
+}
+
+/**
+ * @brief Frees the memory held by a q-gram index.
+ *
+ * @param index Pointer to the index.
+ */
+void qgram_index_free(qgram_index *index) {
+    if (!index) return;
+    utf8_words_free(index->decoded);
+    free(index->by_length);
+    free(index->length_start);
+    free(index->postings);
+    free(index->table);
+    free(index);
+}
+
+/**
+ * @brief Creates the query scratch memory for an index.
+ *
+ * @param index Pointer to the index the scratch is used with.
+ * @return Pointer to the new scratch memory.
+ */
+qgram_scratch *qgram_scratch_create(const qgram_index *index) {
+    qgram_scratch *scratch = malloc(sizeof(qgram_scratch));
+    if (!scratch) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    scratch->counts = calloc((size_t)index->nwords + 1, sizeof(int));
+    scratch->touched = malloc(((size_t)index->nwords + 1) * sizeof(int));
+    if (!scratch->counts || !scratch->touched) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    scratch->candidates = 0;
+    scratch->queries = 0;
+    return scratch;
+}
+
+/**
+ * @brief Frees the query scratch memory.
+ *
+ * @param scratch Pointer to the scratch memory.
+ */
+void qgram_scratch_free(qgram_scratch *scratch) {
+    if (!scratch) return;
+    free(scratch->counts);
+    free(scratch->touched);
+    free(scratch);
+}
+
+/**
+ * @brief Returns the minimum number of q-grams two words within the threshold share.
+ *
+ * @param length1 Length of the first word.
+ * @param length2 Length of the second word.
+ * @param q Length of the q-grams.
+ * @param max_distance Maximum allowed edit distance.
+ * @return The bound; the count filter applies only when it is positive.
+ */
+static int count_bound(int length1, int length2, int q, int max_distance) {
+    int longer = (length1 > length2) ? length1 : length2;
+    return longer - q + 1 - max_distance * q;
+}
+
+/**
+ * @brief A query decoded once for the verifications.
+ */
+typedef struct {
+    const char *word;
+    const unsigned int *codepoints;
+    int length;                  // Length in code points
+    int ascii;                   // Whether `word` is all ASCII
+    unsigned int *buffer;        // Room for the widened ASCII candidates
+} qgram_query;
+
+/**
+ * @brief Verifies a candidate, keeping the closest word found so far.
+ *
+ * Two ASCII words are compared byte by byte, any other pair on their code points.
+ *
+ * @param index Pointer to the index.
+ * @param query Decoded word to be corrected.
+ * @param id Id of the candidate.
+ * @param context Edit distance context.
+ * @param best_id Id of the closest word so far, or -1.
+ * @param best_distance Distance of the closest word so far, or the threshold if none.
+ */
+static void verify_candidate(const qgram_index *index, const qgram_query *query, int id, ed_context *context,
+                             int *best_id, int *best_distance) {
+    int distance;
+    if (query->ascii && index->decoded->start[id] < 0) {
+        distance = edit_distance_bounded_ctx(context, query->word, index->words[id], *best_distance);
+    } else {
+        const unsigned int *codepoints = utf8_words_codepoints(index->decoded, index->words, id, query->buffer);
+        distance = edit_distance_codepoints_ctx(context, query->codepoints, query->length, codepoints,
+                                                index->lengths[id], *best_distance);
+    }
+    if (distance < *best_distance || (distance == *best_distance && (*best_id < 0 || id < *best_id))) {
+        *best_distance = distance;
+        *best_id = id;
+    }
+}
+
+/**
+ * @brief Finds the indexed word closest to a word.
+ *
+ * This function decodes the query into the context, merges the postings lists of its
+ * q-grams, counting for each word the query q-grams that occur in it at most
+ * `max_distance` positions away, then verifies the words whose count reaches the bound of
+ * their length, and every word of the lengths whose bound is not positive.
+ *
+ * @param index Pointer to the index.
+ * @param word Word to be corrected.
+ * @param max_distance Maximum allowed edit distance.
+ * @param scratch Query scratch memory of the calling thread.
+ * @param context Edit distance context of the calling thread.
+ * @param distance Output distance of the closest word; may be NULL.
+ * @return The id of the closest word, or -1 if no word is within `max_distance`.
+ */
+int qgram_index_find_closest(const qgram_index *index, const char *word, int max_distance, qgram_scratch *scratch,
+                             ed_context *context, int *distance) {
+    size_t bytes = strlen(word);
+    unsigned int *codepoints = ed_context_codepoints(context, bytes + (size_t)index->max_length);
+    int length = utf8_decode(word, codepoints);
+    qgram_query query = {word, codepoints, length, utf8_is_ascii(word, bytes), codepoints + length};
+    int q = index->q;
+    int min_length = (length - max_distance > 0) ? length - max_distance : 0;
+    int max_length = (length + max_distance < index->max_length) ? length + max_distance : index->max_length;
+    int ntouched = 0;
+    int best_id = -1;
+    int best_distance = max_distance;
+
+    scratch->queries++;
+    if (max_distance < 0) {
+        return -1;
+    }
+
+    // Count the shared q-grams, each query q-gram at most once per word
+    for (int position = 0; position + q <= length; ++position) {
+        const qgram_slot *slot = find_postings(index, qgram_key(codepoints + position, q));
+        if (!slot) continue;
+        int last_id = -1;
+        for (int p = slot->start; p < slot->start + slot->count; ++p) {
+            const qgram_posting *posting = &index->postings[p];
+            if (posting->id == last_id) continue;
+            int shift = posting->position - position;
+            if (shift < -max_distance || shift > max_distance) continue;
+            int word_length = index->lengths[posting->id];
+            if (word_length < min_length || word_length > max_length) continue;
+            if (scratch->counts[posting->id]++ == 0) {
+                scratch->touched[ntouched++] = posting->id;
+            }
+            last_id = posting->id;
+        }
+    }
+
+    for (int t = 0; t < ntouched; ++t) {
+        int id = scratch->touched[t];
+        int bound = count_bound(length, index->lengths[id], q, max_distance);
+        if (bound > 0 && scratch->counts[id] >= bound) {
+            scratch->candidates++;
+            verify_candidate(index, &query, id, context, &best_id, &best_distance);
+        }
+        scratch->counts[id] = 0;
+    }
+
+    for (int l = min_length; l <= max_length; ++l) {
+        if (count_bound(length, l, q, max_distance) > 0) continue;
+        for (int b = index->length_start[l]; b < index->length_start[l + 1]; ++b) {
+            scratch->candidates++;
+            verify_candidate(index, &query, index->by_length[b], context, &best_id, &best_distance);
+        }
+    }
+
+    if (distance) {
+        *distance = (best_id >= 0) ? best_distance : -1;
+    }
+    return best_id;
+}
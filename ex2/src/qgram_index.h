@@ -0,0 +1,118 @@
+#ifndef QGRAM_INDEX_H
+#define QGRAM_INDEX_H
+
+#include "edit_distance.h"
+#include "utf8.h"
+
+#define QGRAM_MAX_Q 8 // Longest q-gram supported
+
+/**
+ * @brief One occurrence of a q-gram: the word it occurs in and its position there.
+ */
+typedef struct {
+    int id;
+    int position;
+} qgram_posting;
+
+/**
+ * @brief A slot of the table mapping a q-gram to its postings list.
+ *
+ * The postings list is the run `[start, start + count)` of the postings array, sorted by
+ * word and then by position. Q-grams are identified by a 64-bit hash of their code points:
+ * q-grams sharing a hash share a list, which can only make the count filter let more
+ * candidates through.
+ */
+typedef struct {
+    unsigned long long key;
+    int start;
+    int count;
+} qgram_slot;
+
+/**
+ * @brief Positional q-gram inverted index over a list of words.
+ *
+ * Words are sequences of code points, so that an accented letter is one character. With
+ * insertions and deletions only, every edit operation destroys at most `q` of the
+ * q-grams of a word and moves the others by one position, so two words within distance `k`
+ * share at least `max(|x|, |y|) - q + 1 - k * q` q-grams at positions at most `k` apart.
+ * The index counts those shared q-grams by merging the postings lists of the q-grams of
+ * the query; words of the lengths for which the bound is not positive cannot be filtered
+ * and are taken from a by-length list instead.
+ */
+typedef struct {
+    char **words;            // Indexed words; they must outlive the index
+    int nwords;
+    int q;
+    utf8_words *decoded;     // Code points of the non-ASCII words
+    int *lengths;            // Length of each word in code points, owned by `decoded`
+    int max_length;
+    int *by_length;          // Word ids sorted by length, then by id
+    int *length_start;       // Start of each length in `by_length`, `max_length + 2` entries
+    qgram_posting *postings;
+    qgram_slot *table;
+    size_t capacity;         // Number of slots of the table, a power of two
+} qgram_index;
+
+/**
+ * @brief Per-thread scratch memory of the index queries.
+ */
+typedef struct {
+    int *counts;             // Shared q-grams of each word with the current query
+    int *touched;            // Words with a nonzero count
+    long long candidates;    // Words verified so far
+    long long queries;       // Queries answered so far
+} qgram_scratch;
+
+/**
+ * @brief Builds the positional q-gram index of a list of words.
+ *
+ * @param words Array of pointers to the words; ids are positions in this array.
+ * @param nwords Number of words.
+ * @param q Length of the q-grams, from 1 to `QGRAM_MAX_Q`.
+ * @return Pointer to the new index, or NULL if `q` is not supported.
+ */
+qgram_index *qgram_index_build(char **words, int nwords, int q);
+
+/**
+ * @brief Frees the memory held by a q-gram index.
+ *
+ * @param index Pointer to the index.
+ */
+void qgram_index_free(qgram_index *index);
+
+/**
+ * @brief Creates the query scratch memory for an index.
+ *
+ * @param index Pointer to the index the scratch is used with.
+ * @return Pointer to the new scratch memory.
+ */
+qgram_scratch *qgram_scratch_create(const qgram_index *index);
+
+/**
+ * @brief Frees the query scratch memory.
+ *
+ * @param scratch Pointer to the scratch memory.
+ */
+void qgram_scratch_free(qgram_scratch *scratch);
+
+/**
+ * @brief Finds the indexed word closest to a word.
+ *
+ * Candidates passing the count filter, or of a length the filter cannot handle, are
+ * verified with `edit_distance_bounded_ctx`, or `edit_distance_codepoints_ctx` when one of
+ * the words is not ASCII, the bound shrinking as closer words are found.
+ * Among equally close words the one with the smallest id is returned, as the linear search
+ * does.
+ *
+ * @param index Pointer to the index.
+ * @param word Word to be corrected.
+ * @param max_distance Maximum allowed edit distance.
+ * @param scratch Query scratch memory of the calling thread.
+ * @param context Edit distance context of the calling thread.
+ * @param distance Output distance of the closest word; may be NULL.
+ * @return The id of the closest word, or -1 if no word is within `max_distance`.
+ */
+int qgram_index_find_closest(const qgram_index *index, const char *word, int max_distance, qgram_scratch *scratch,
+                             ed_context *context, int *distance);
+
+#endif // QGRAM_INDEX_H
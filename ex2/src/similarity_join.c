@@ -0,0 +1,447 @@
+#include "similarity_join.h"
+#include "edit_distance.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JOIN_CHUNK 256             // Left strings taken by a worker at a time
+#define JOIN_BUFFER_SIZE (1 << 16) // Size of the output buffer of each worker
+
+/**
+ * @brief A segment of a right string, identified by the hash of its length, position and content.
+ */
+typedef struct {
+    unsigned long long key;
+    int id;
+} segment_entry;
+
+/**
+ * @brief A slot of the table mapping a segment key to its postings list.
+ *
+ * The postings list is the run `[start, start + count)` of the sorted segment entries.
+ */
+typedef struct {
+    unsigned long long key;
+    int start;
+    int count;
+} postings_slot;
+
+/**
+ * @brief Segment index built over the right list.
+ */
+typedef struct {
+    char **right;
+    int nright;
+    int max_distance;
+    segment_entry *entries;
+    postings_slot *table;
+    size_t capacity;
+} join_index;
+
+/**
+ * @brief State of a worker thread.
+ */
+typedef struct {
+    const join_index *index;
+    char **left;
+    int nleft;
+    int *next_left;          // Shared cursor on the left list
+    pthread_mutex_t *lock;   // Protects `next_left` and `out`
+    FILE *out;
+    long pairs;
+} join_worker;
+
+/**
+ * @brief A list of strings read from a file, stored in a single buffer.
+ */
+typedef struct {
+    char *storage;
+    char **words;
+    int count;
+} word_list;
+
+/**
+ * @brief Hashes a segment together with the string length and the segment number.
+ *
+ * @param length Length of the string the segment belongs to.
+ * @param segment Number of the segment.
+ * @param s Pointer to the first character of the segment.
+ * @param n Length of the segment.
+ * @return The key of the segment.
+ */
+static unsigned long long segment_key(int length, int segment, const char *s, int n) {
+    unsigned long long hash = 14695981039346656037ULL;
+    hash ^= (unsigned long long)length * 31 + (unsigned long long)segment;
+    hash *= 1099511628211ULL;
+    for (int i = 0; i < n; ++i) {
+        hash ^= (unsigned char)s[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Computes the position and length of a segment of a string.
+ *
+ * A string of length `length` is cut into `parts` segments of almost equal length, the
+ * last `length % parts` of which are one character longer.
+ *
+ * @param length Length of the string.
+ * @param parts Number of segments.
+ * @param segment Number of the segment.
+ * @param start Output start position of the segment.
+ * @param n Output length of the segment.
+ */
+static void segment_bounds(int length, int parts, int segment, int *start, int *n) {
+    int base = length / parts;
+    int shorter = parts - length % parts;
+    if (segment < shorter) {
+        *start = segment * base;
+        *n = base;
+    } else {
+        *start = shorter * base + (segment - shorter) * (base + 1);
+        *n = base + 1;
+    }
+}
+
+/**
+ * @brief Orders segment entries by key, then by id.
+ *
+ * @param e1 Pointer to the first entry.
+ * @param e2 Pointer to the second entry.
+ * @return A negative, zero or positive value as the first entry sorts before, with or after the second.
+ */
+static int compare_entries(const void *e1, const void *e2) {
+    const segment_entry *a = e1;
+    const segment_entry *b = e2;
+    if (a->key != b->key) return (a->key < b->key) ? -1 : 1;
+    return (a->id > b->id) - (a->id < b->id);
+}
+
+/**
+ * @brief Looks up the postings list of a segment key.
+ *
+ * @param index Segment index.
+ * @param key Key of the segment.
+ * @return The slot of the key, or NULL if no right string has such a segment.
+ */
+static const postings_slot *find_postings(const join_index *index, unsigned long long key) {
+    size_t slot = (size_t)key & (index->capacity - 1);
+    while (index->table[slot].count > 0) {
+        if (index->table[slot].key == key) {
+            return &index->table[slot];
+        }
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Builds the segment index over the right list.
+ *
+ * @param index Index to initialize.
+ * @param right Array of pointers to the strings of the right list.
+ * @param nright Number of strings in the right list.
+ * @param max_distance Maximum allowed edit distance.
+ */
+static void build_index(join_index *index, char **right, int nright, int max_distance) {
+    int parts = max_distance + 1;
+    size_t nentries = (size_t)nright * (size_t)parts;
+
+    index->right = right;
+    index->nright = nright;
+    index->max_distance = max_distance;
+    index->entries = malloc((nentries + 1) * sizeof(segment_entry));
+    if (!index->entries) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t e = 0;
+    for (int id = 0; id < nright; ++id) {
+        int length = (int)strlen(right[id]);
+        for (int segment = 0; segment < parts; ++segment) {
+            int start, n;
+            segment_bounds(length, parts, segment, &start, &n);
+            index->entries[e].key = segment_key(length, segment, right[id] + start, n);
+            index->entries[e].id = id;
+            e++;
+        }
+    }
+    qsort(index->entries, nentries, sizeof(segment_entry), compare_entries);
+
+    index->capacity = 16;
+    while (index->capacity < 2 * nentries) index->capacity <<= 1;
+    index->table = calloc(index->capacity, sizeof(postings_slot));
+    if (!index->table) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t run = 0;
+    while (run < nentries) {
+        size_t end = run;
+        while (end < nentries && index->entries[end].key == index->entries[run].key) end++;
+        size_t slot = (size_t)index->entries[run].key & (index->capacity - 1);
+        while (index->table[slot].count > 0) slot = (slot + 1) & (index->capacity - 1);
+        index->table[slot].key = index->entries[run].key;
+        index->table[slot].start = (int)run;
+        index->table[slot].count = (int)(end - run);
+        run = end;
+    }
+}
+
+/**
+ * @brief Writes the buffered pairs of a worker to the output stream.
+ *
+ * @param worker Worker whose buffer is flushed.
+ * @param buffer Output buffer.
+ * @param used Number of bytes used in the buffer.
+ */
+static void flush_buffer(join_worker *worker, const char *buffer, size_t used) {
+    if (used == 0) return;
+    pthread_mutex_lock(worker->lock);
+    fwrite(buffer, 1, used, worker->out);
+    pthread_mutex_unlock(worker->lock);
+}
+
+/**
+ * @brief Body of a worker thread: joins chunks of the left list against the index.
+ *
+ * For every left string `r` and every length `l` compatible with the threshold, segment `i`
+ * of the right strings of length `l` can only reappear in `r` shifted by `(delta - k) / 2` to
+ * `(delta + k) / 2` positions, where `delta = |r| - l`: only those substrings are probed.
+ * A right string found through several segments is verified once, thanks to a per-worker
+ * array of stamps, and verification reuses the scratch rows of a per-worker context.
+ *
+ * @param arg Pointer to the `join_worker` state.
+ * @return NULL.
+ */
+static void *join_worker_run(void *arg) {
+    join_worker *worker = arg;
+    const join_index *index = worker->index;
+    int k = index->max_distance;
+    int parts = k + 1;
+
+    int *stamps = calloc((size_t)index->nright + 1, sizeof(int));
+    char *buffer = malloc(JOIN_BUFFER_SIZE);
+    ed_context *context = ed_context_create();
+    if (!stamps || !buffer) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    size_t used = 0;
+
+    for (;;) {
+        pthread_mutex_lock(worker->lock);
+        int first = *worker->next_left;
+        *worker->next_left += JOIN_CHUNK;
+        pthread_mutex_unlock(worker->lock);
+        if (first >= worker->nleft) break;
+        int last = (first + JOIN_CHUNK < worker->nleft) ? first + JOIN_CHUNK : worker->nleft;
+
+        for (int r = first; r < last; ++r) {
+            const char *query = worker->left[r];
+            int query_length = (int)strlen(query);
+            int stamp = r + 1;
+
+            for (int length = query_length - k; length <= query_length + k; ++length) {
+                if (length < 0) continue;
+                int delta = query_length - length;
+                int lo_shift = -((k - delta) / 2);
+                int hi_shift = (delta + k) / 2;
+
+                for (int segment = 0; segment < parts; ++segment) {
+                    int start, n;
+                    segment_bounds(length, parts, segment, &start, &n);
+                    for (int pos = start + lo_shift; pos <= start + hi_shift; ++pos) {
+                        if (pos < 0 || pos + n > query_length) continue;
+                        const postings_slot *p = find_postings(index, segment_key(length, segment, query + pos, n));
+                        if (!p) continue;
+
+                        for (int e = p->start; e < p->start + p->count; ++e) {
+                            int id = index->entries[e].id;
+                            if (stamps[id] == stamp) continue; // Already verified for this query
+                            stamps[id] = stamp;
+
+                            int dist = edit_distance_bounded_ctx(context, query, index->right[id], k);
+                            if (dist > k) continue;
+
+                            size_t needed = strlen(query) + strlen(index->right[id]) + 16;
+                            if (used + needed > JOIN_BUFFER_SIZE) {
+                                flush_buffer(worker, buffer, used);
+                                used = 0;
+                            }
+                            if (needed > JOIN_BUFFER_SIZE) {
+                                pthread_mutex_lock(worker->lock);
+                                fprintf(worker->out, "%s\t%s\t%d\n", query, index->right[id], dist);
+                                pthread_mutex_unlock(worker->lock);
+                            } else {
+                                used += (size_t)sprintf(buffer + used, "%s\t%s\t%d\n", query, index->right[id], dist);
+                            }
+                            worker->pairs++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    flush_buffer(worker, buffer, used);
+    ed_context_free(context);
+    free(buffer);
+    free(stamps);
+    return NULL;
+}
+
+/**
+ * @brief Finds every pair of strings from two lists whose edit distance is within a threshold.
+ *
+ * This function builds the segment index over the right list, then starts the worker
+ * threads, which pull chunks of the left list from a shared cursor and stream their
+ * matches to `out`. The order of the pairs in the output is not specified.
+ *
+ * @param left Array of pointers to the strings of the left list.
+ * @param nleft Number of strings in the left list.
+ * @param right Array of pointers to the strings of the right list.
+ * @param nright Number of strings in the right list.
+ * @param max_distance Maximum allowed edit distance.
+ * @param num_threads Number of worker threads.
+ * @param out Stream the matching pairs are written to.
+ * @return The number of matching pairs.
+ */
+long similarity_join(char **left, int nleft, char **right, int nright, int max_distance, int num_threads, FILE *out) {
+    if (max_distance < 0 || nleft == 0 || nright == 0) {
+        return 0;
+    }
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+
+    join_index index;
+    build_index(&index, right, nright, max_distance);
+
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    int next_left = 0;
+    pthread_t *threads = malloc((size_t)num_threads * sizeof(pthread_t));
+    join_worker *workers = malloc((size_t)num_threads * sizeof(join_worker));
+    if (!threads || !workers) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int t = 0; t < num_threads; ++t) {
+        workers[t].index = &index;
+        workers[t].left = left;
+        workers[t].nleft = nleft;
+        workers[t].next_left = &next_left;
+        workers[t].lock = &lock;
+        workers[t].out = out;
+        workers[t].pairs = 0;
+        if (pthread_create(&threads[t], NULL, join_worker_run, &workers[t]) != 0) {
+            perror("Error creating worker thread");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    long pairs = 0;
+    for (int t = 0; t < num_threads; ++t) {
+        pthread_join(threads[t], NULL);
+        pairs += workers[t].pairs;
+    }
+
+    free(workers);
+    free(threads);
+    free(index.table);
+    free(index.entries);
+    return pairs;
+}
+
+/**
+ * @brief Reads a list of strings from a file, one per line.
+ *
+ * Lines may end with LF, CRLF or a bare CR, and empty lines give empty strings.
+ *
+ * @param path Path to the file.
+ * @param list Output list.
+ * @return 0 on success, -1 if the file cannot be read.
+ */
+static int read_word_list(const char *path, word_list *list) {
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        perror("Error opening word list");
+        return -1;
+    }
+
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    if (size < 0) {
+        perror("Error reading word list");
+        fclose(in);
+        return -1;
+    }
+
+    list->storage = malloc((size_t)size + 1);
+    if (!list->storage) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    size_t read = fread(list->storage, 1, (size_t)size, in);
+    fclose(in);
+    list->storage[read] = '\0';
+
+    // Lines end with LF, CRLF or a bare CR; each ending is counted, so there is room for every line
+    int count = 0;
+    for (size_t i = 0; i < read; ++i) {
+        if (list->storage[i] == '\n' || list->storage[i] == '\r') count++;
+    }
+    list->words = malloc((size_t)(count + 1) * sizeof(char *));
+    if (!list->words) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    // Empty lines are kept, since the empty string is a valid input of the join
+    list->count = 0;
+    char *start = list->storage;
+    char *end = list->storage + read;
+    while (start < end) {
+        char *stop = start;
+        while (stop < end && *stop != '\n' && *stop != '\r') stop++;
+        list->words[list->count++] = start;
+        if (stop + 1 < end && stop[0] == '\r' && stop[1] == '\n') *stop++ = '\0';
+        if (stop < end) *stop++ = '\0';
+        start = stop;
+    }
+    return 0;
+}
+
+/**
+ * @brief Runs `similarity_join` on two word lists read from files, one string per line.
+ *
+ * @param left_file Path to the file with the left list.
+ * @param right_file Path to the file with the right list.
+ * @param max_distance Maximum allowed edit distance.
+ * @param num_threads Number of worker threads.
+ * @param out Stream the matching pairs are written to.
+ * @return The number of matching pairs, or -1 if a file cannot be read.
+ */
+long similarity_join_files(const char *left_file, const char *right_file, int max_distance, int num_threads, FILE *out) {
+    word_list left, right;
+    if (read_word_list(left_file, &left) != 0) return -1;
+    if (read_word_list(right_file, &right) != 0) {
+        free(left.words);
+        free(left.storage);
+        return -1;
+    }
+
+    long pairs = similarity_join(left.words, left.count, right.words, right.count, max_distance, num_threads, out);
+
+    free(left.words);
+    free(left.storage);
+    free(right.words);
+    free(right.storage);
+    return pairs;
+}
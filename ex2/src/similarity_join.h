@@ -0,0 +1,39 @@
+#ifndef SIMILARITY_JOIN_H
+#define SIMILARITY_JOIN_H
+
+#include <stdio.h>
+
+/**
+ * @brief Finds every pair of strings from two lists whose edit distance is within a threshold.
+ *
+ * The right list is indexed with the partition-based PassJoin scheme: every string is cut
+ * into `max_distance + 1` segments, and since at most `max_distance` of them can be touched
+ * by the edit operations, a similar string must contain one of the segments unchanged near
+ * its original position. Candidates sharing such a segment are verified with
+ * `edit_distance_bounded`. The left list is split among `num_threads` worker threads and
+ * each matching pair is written to `out` as soon as it is found, as `left<TAB>right<TAB>distance`.
+ *
+ * @param left Array of pointers to the strings of the left list.
+ * @param nleft Number of strings in the left list.
+ * @param right Array of pointers to the strings of the right list.
+ * @param nright Number of strings in the right list.
+ * @param max_distance Maximum allowed edit distance.
+ * @param num_threads Number of worker threads (values below 1 are treated as 1).
+ * @param out Stream the matching pairs are written to.
+ * @return The number of matching pairs.
+ */
+long similarity_join(char **left, int nleft, char **right, int nright, int max_distance, int num_threads, FILE *out);
+
+/**
+ * @brief Runs `similarity_join` on two word lists read from files, one string per line.
+ *
+ * @param left_file Path to the file with the left list.
+ * @param right_file Path to the file with the right list.
+ * @param max_distance Maximum allowed edit distance.
+ * @param num_threads Number of worker threads.
+ * @param out Stream the matching pairs are written to.
+ * @return The number of matching pairs, or -1 if a file cannot be read.
+ */
+long similarity_join_files(const char *left_file, const char *right_file, int max_distance, int num_threads, FILE *out);
+
+#endif // SIMILARITY_JOIN_H
@@ -1,6 +1,18 @@
 #include <stdio.h>
 #include <string.h>
 #include "edit_distance.h"
+#include "line_diff.h"
+#include "similarity_join.h"
+#include "dawg.h"
+#include "lev_automaton.h"
+#include "wavefront.h"
+#include "ed_cursor.h"
+#include "qgram_index.h"
+#include "word_set.h"
+#include "bloom_filter.h"
+#include "batch_search.h"
+#include "utf8.h"
+#include <stdlib.h>
 #define UNITY_H
 #include "unity.h"
 
@@ -36,6 +48,476 @@ void run_edit_distance_dyn_tests() {
     printf("edit_distance_dyn(\"pioppo\", \"pioppo\") = %d (expected 0)\n", edit_distance_dyn("pioppo", "pioppo"));
 }
 
+/**
+ * @brief Computes the Myers edit distance between two strings, treating each character as a symbol.
+ * 
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @return The edit distance computed by `myers_diff`.
+ */
+int myers_diff_strings(const char *s1, const char *s2) {
+    unsigned int a[64], b[64];
+    int n = 0, m = 0;
+    while (s1[n]) { a[n] = (unsigned char)s1[n]; n++; }
+    while (s2[m]) { b[m] = (unsigned char)s2[m]; m++; }
+    return myers_diff(a, n, b, m, NULL, NULL);
+}
+
+/**
+ * @brief Runs tests for the `myers_diff` function.
+ * 
+ * This function executes a series of tests to verify that the O(ND) algorithm used by the
+ * line-level diff mode agrees with the dynamic programming edit distance.
+ */
+void run_myers_diff_tests() {
+    printf("--- Running myers_diff tests ---\n");
+    printf("myers_diff(\"casa\", \"cassa\") = %d (expected 1)\n", myers_diff_strings("casa", "cassa"));
+    printf("myers_diff(\"casa\", \"cara\") = %d (expected 2)\n", myers_diff_strings("casa", "cara"));
+    printf("myers_diff(\"vinaio\", \"vino\") = %d (expected 2)\n", myers_diff_strings("vinaio", "vino"));
+    printf("myers_diff(\"tassa\", \"passato\") = %d (expected 4)\n", myers_diff_strings("tassa", "passato"));
+    printf("myers_diff(\"pioppo\", \"pioppo\") = %d (expected 0)\n", myers_diff_strings("pioppo", "pioppo"));
+    printf("myers_diff(\"\", \"abc\") = %d (expected 3)\n", myers_diff_strings("", "abc"));
+}
+
+/**
+ * @brief Writes a string to a file.
+ * 
+ * @param path Path to the file.
+ * @param contents String to write.
+ */
+void write_file(const char *path, const char *contents) {
+    FILE *file = fopen(path, "wb");
+    if (file) {
+        fputs(contents, file);
+        fclose(file);
+    }
+}
+
+/**
+ * @brief Runs tests for the `line_diff_files` function.
+ * 
+ * This function compares files that differ only in the newline at the end of the last
+ * line, which must differ as they do for `diff` and be marked in the script, and two
+ * identical files without it.
+ */
+void run_line_diff_tests() {
+    char script[256];
+    printf("--- Running line_diff_files tests ---\n");
+    write_file("line_diff_a.txt", "a\nb\nc\n");
+    write_file("line_diff_b.txt", "a\nb\nc");
+    FILE *out = tmpfile();
+    int distance = line_diff_files("line_diff_a.txt", "line_diff_b.txt", out);
+    size_t length = 0;
+    if (out) {
+        rewind(out);
+        length = fread(script, 1, sizeof(script) - 1, out);
+        fclose(out);
+    }
+    script[length] = '\0';
+    printf("line_diff_files(\"a b c\\n\", \"a b c\") = %d (expected 2)\n", distance);
+    printf("line_diff_files(\"a b c\\n\", \"a b c\") marks the missing newline = %d (expected 1)\n",
+           strstr(script, "+c\n\\ No newline at end of file\n") != NULL);
+    out = tmpfile();
+    distance = line_diff_files("line_diff_b.txt", "line_diff_b.txt", out);
+    if (out) fclose(out);
+    printf("line_diff_files(\"a b c\", \"a b c\") = %d (expected 0)\n", distance);
+    remove("line_diff_a.txt");
+    remove("line_diff_b.txt");
+}
+
+/**
+ * @brief Runs tests for the `edit_distance_bounded` function.
+ * 
+ * This function checks that distances within the threshold are computed exactly and that
+ * larger ones are reported as `max_distance + 1`.
+ */
+void run_edit_distance_bounded_tests() {
+    printf("--- Running edit_distance_bounded tests ---\n");
+    printf("edit_distance_bounded(\"casa\", \"cassa\", 2) = %d (expected 1)\n", edit_distance_bounded("casa", "cassa", 2));
+    printf("edit_distance_bounded(\"casa\", \"cara\", 2) = %d (expected 2)\n", edit_distance_bounded("casa", "cara", 2));
+    printf("edit_distance_bounded(\"tassa\", \"passato\", 2) = %d (expected 3)\n", edit_distance_bounded("tassa", "passato", 2));
+    printf("edit_distance_bounded(\"tassa\", \"passato\", 4) = %d (expected 4)\n", edit_distance_bounded("tassa", "passato", 4));
+    printf("edit_distance_bounded(\"pioppo\", \"pioppo\", 0) = %d (expected 0)\n", edit_distance_bounded("pioppo", "pioppo", 0));
+}
+
+/**
+ * @brief Runs tests for the `edit_distance_diagonal` function.
+ * 
+ * This function checks the diagonal transition kernel on the usual word pairs, then on two
+ * long near-identical strings, which `edit_distance_dyn` also hands to it, against the
+ * banded kernel run with a threshold that never applies.
+ */
+void run_edit_distance_diagonal_tests() {
+    printf("--- Running edit_distance_diagonal tests ---\n");
+    printf("edit_distance_diagonal(\"casa\", \"cassa\", 2) = %d (expected 1)\n", edit_distance_diagonal("casa", "cassa", 2));
+    printf("edit_distance_diagonal(\"tassa\", \"passato\", 2) = %d (expected 3)\n", edit_distance_diagonal("tassa", "passato", 2));
+    printf("edit_distance_diagonal(\"tassa\", \"passato\", 4) = %d (expected 4)\n", edit_distance_diagonal("tassa", "passato", 4));
+    printf("edit_distance_diagonal(\"\", \"pioppo\", 6) = %d (expected 6)\n", edit_distance_diagonal("", "pioppo", 6));
+
+    int len = 5000;
+    char *s1 = malloc((size_t)len + 1);
+    char *s2 = malloc((size_t)len + 2);
+    srand(7);
+    for (int i = 0; i < len; ++i) s1[i] = (char)('a' + rand() % 4);
+    s1[len] = '\0';
+    memcpy(s2, s1, (size_t)len + 1);
+    s2[100] = 'z';                                    // Substitution: two operations
+    memmove(s2 + 3001, s2 + 3000, (size_t)len - 3000 + 1);
+    s2[3000] = 'y';                                   // Insertion: one operation
+    printf("edit_distance_diagonal(long strings, 10) = %d (expected 3)\n", edit_distance_diagonal(s1, s2, 10));
+    printf("edit_distance_dyn(long strings) = %d", edit_distance_dyn(s1, s2));
+    printf(" (expected %d)\n", edit_distance_bounded(s1, s2, 2 * len + 1));
+    free(s1);
+    free(s2);
+}
+
+/**
+ * @brief Runs tests for the `similarity_join` function.
+ * 
+ * This function joins two small word lists and checks the number of pairs within the
+ * threshold against the count obtained by comparing every pair with `edit_distance_dyn`,
+ * then joins two files with bare CR and CRLF line endings, where empty lines also match.
+ */
+void run_similarity_join_tests() {
+    char *left[] = {"casa", "cara", "vinaio", "tassa", "pioppo", "gatto"};
+    char *right[] = {"cassa", "casa", "vino", "passato", "pioppi", "matto", "cane"};
+    int nleft = 6, nright = 7;
+
+    printf("--- Running similarity_join tests ---\n");
+    for (int k = 0; k <= 3; ++k) {
+        long expected = 0;
+        for (int i = 0; i < nleft; ++i)
+            for (int j = 0; j < nright; ++j)
+                if (edit_distance_dyn(left[i], right[j]) <= k) expected++;
+
+        FILE *out = tmpfile();
+        long pairs = similarity_join(left, nleft, right, nright, k, 2, out);
+        if (out) fclose(out);
+        printf("similarity_join(k = %d) = %ld (expected %ld)\n", k, pairs, expected);
+    }
+
+    write_file("join_left.txt", "casa\rcara\r\rvino\r");
+    write_file("join_right.txt", "\r\ncassa\r\n");
+    FILE *out = tmpfile();
+    long pairs = similarity_join_files("join_left.txt", "join_right.txt", 1, 2, out);
+    if (out) fclose(out);
+    printf("similarity_join_files(CR lines, empty line, k = 1) = %ld (expected 2)\n", pairs);
+    remove("join_left.txt");
+    remove("join_right.txt");
+}
+
+/**
+ * @brief Counts the words visited by `dawg_compact_iterate`.
+ * 
+ * @param word Word visited.
+ * @param arg Pointer to the counter.
+ */
+void count_word(const char *word, void *arg) {
+    (void)word;
+    (*(int *)arg)++;
+}
+
+/**
+ * @brief Runs tests for the dictionary automaton and the Levenshtein automaton search.
+ * 
+ * This function builds the minimal automaton of a small dictionary, checks membership of
+ * words inside and outside of it in both layouts, and searches the closest word to
+ * misspelled queries.
+ */
+void run_automaton_tests() {
+    char *dictionary[] = {"cassa", "casa", "vino", "passato", "pioppo", "casa", "cane", "pane"};
+    dawg *automaton = dawg_build(dictionary, 8);
+    dawg_compact *compact = dawg_compact_build(automaton);
+    char closest[64];
+    int visited = 0;
+    lev_automaton query;
+
+    printf("--- Running automaton tests ---\n");
+    printf("dawg word_count = %d (expected 7)\n", automaton->word_count);
+    printf("dawg_contains(\"casa\") = %d (expected 1)\n", dawg_contains(automaton, "casa"));
+    printf("dawg_contains(\"cas\") = %d (expected 0)\n", dawg_contains(automaton, "cas"));
+    printf("dawg_contains(\"pioppi\") = %d (expected 0)\n", dawg_contains(automaton, "pioppi"));
+    printf("dawg_compact_contains(\"pane\") = %d (expected 1)\n", dawg_compact_contains(compact, "pane"));
+    printf("dawg_compact_contains(\"pan\") = %d (expected 0)\n", dawg_compact_contains(compact, "pan"));
+    printf("dawg_compact_contains(\"passatore\") = %d (expected 0)\n", dawg_compact_contains(compact, "passatore"));
+    printf("dawg_compact_iterate() = %d", dawg_compact_iterate(compact, count_word, &visited));
+    printf(", visited %d (expected 7)\n", visited);
+
+    lev_automaton_init(&query, "cara", 2);
+    printf("lev_automaton_find_closest(\"cara\") = %d (expected 2)", lev_automaton_find_closest(&query, compact, closest, sizeof(closest)));
+    printf(" -> %s (expected casa)\n", closest);
+    lev_automaton_init(&query, "vinaio", 2);
+    printf("lev_automaton_find_closest(\"vinaio\") = %d (expected 2)", lev_automaton_find_closest(&query, compact, closest, sizeof(closest)));
+    printf(" -> %s (expected vino)\n", closest);
+    lev_automaton_init(&query, "cassa", 2);
+    printf("lev_automaton_find_closest(\"cassa\") = %d (expected 0)", lev_automaton_find_closest(&query, compact, closest, sizeof(closest)));
+    printf(" -> %s (expected cassa)\n", closest);
+    lev_automaton_init(&query, "tassa", 1);
+    printf("lev_automaton_find_closest(\"tassa\", 1) = %d (expected -1)\n", lev_automaton_find_closest(&query, compact, closest, sizeof(closest)));
+
+    dawg_compact_free(compact);
+    dawg_free(automaton);
+}
+
+/**
+ * @brief Runs tests for the `edit_distance_wavefront` function.
+ * 
+ * This function checks the tiled kernel on the usual word pairs, then on two random strings
+ * spanning several tiles, against the banded kernel run with a threshold that never applies.
+ */
+void run_edit_distance_wavefront_tests() {
+    printf("--- Running edit_distance_wavefront tests ---\n");
+    printf("edit_distance_wavefront(\"casa\", \"cassa\") = %d (expected 1)\n", edit_distance_wavefront("casa", "cassa", 2));
+    printf("edit_distance_wavefront(\"tassa\", \"passato\") = %d (expected 4)\n", edit_distance_wavefront("tassa", "passato", 2));
+    printf("edit_distance_wavefront(\"\", \"pioppo\") = %d (expected 6)\n", edit_distance_wavefront("", "pioppo", 2));
+
+    int len1 = 3 * WAVEFRONT_TILE + 17, len2 = 2 * WAVEFRONT_TILE + 301;
+    char *s1 = malloc((size_t)len1 + 1);
+    char *s2 = malloc((size_t)len2 + 1);
+    srand(42);
+    for (int i = 0; i < len1; ++i) s1[i] = (char)('a' + rand() % 4);
+    for (int i = 0; i < len2; ++i) s2[i] = (char)('a' + rand() % 4);
+    s1[len1] = '\0';
+    s2[len2] = '\0';
+    printf("edit_distance_wavefront(long strings) = %d", edit_distance_wavefront(s1, s2, 3));
+    printf(" (expected %d)\n", edit_distance_bounded(s1, s2, len1 + len2));
+    free(s1);
+    free(s2);
+}
+
+/**
+ * @brief Runs tests for the incremental edit distance cursor.
+ * 
+ * This function types a word one character at a time against a fixed word, checking the
+ * distance after each keystroke and after backspaces, then searches a small dictionary
+ * with a threshold the Levenshtein automaton does not support.
+ */
+void run_ed_cursor_tests() {
+    char *dictionary[] = {"cassa", "casa", "vino", "passato", "pioppo", "cane", "pane"};
+    dawg_compact *compact = dawg_compact_from_words(dictionary, 7);
+    ed_cursor *cursor = ed_cursor_create("passato");
+    char closest[64];
+
+    printf("--- Running ed_cursor tests ---\n");
+    printf("ed_cursor_distance(\"\", \"passato\") = %d (expected 7)\n", ed_cursor_distance(cursor));
+    ed_cursor_push(cursor, 't');
+    ed_cursor_push(cursor, 'a');
+    ed_cursor_push(cursor, 's');
+    printf("ed_cursor_prefix_distance(\"tas\", \"passato\") = %d (expected 2)\n", ed_cursor_prefix_distance(cursor));
+    ed_cursor_push(cursor, 's');
+    ed_cursor_push(cursor, 'a');
+    printf("ed_cursor_distance(\"tassa\", \"passato\") = %d (expected 4)\n", ed_cursor_distance(cursor));
+    ed_cursor_pop(cursor);
+    ed_cursor_pop(cursor);
+    ed_cursor_pop(cursor);
+    printf("ed_cursor_distance(\"ta\", \"passato\") = %d (expected 7)\n", ed_cursor_distance(cursor));
+    ed_cursor_pop(cursor);
+    ed_cursor_pop(cursor);
+    printf("ed_cursor_pop(\"\") = %d (expected 0)\n", ed_cursor_pop(cursor));
+    ed_cursor_free(cursor);
+
+    printf("ed_cursor_find_closest(\"pessimo\", 5) = %d (expected -1)\n", ed_cursor_find_closest("pessimo", compact, 5, closest, sizeof(closest)));
+    printf("ed_cursor_find_closest(\"pessimo\", 6) = %d (expected 6)", ed_cursor_find_closest("pessimo", compact, 6, closest, sizeof(closest)));
+    printf(" -> %s (expected passato)\n", closest);
+    printf("ed_cursor_find_closest(\"vinaio\", 3) = %d (expected 2)", ed_cursor_find_closest("vinaio", compact, 3, closest, sizeof(closest)));
+    printf(" -> %s (expected vino)\n", closest);
+
+    dawg_compact_free(compact);
+}
+
+/**
+ * @brief Runs tests for the context-taking variants of the edit distance kernels.
+ * 
+ * This function reuses one context across the usual word pairs, so that later calls run on
+ * scratch memory left by longer strings, and checks the statistics it collects.
+ */
+void run_ed_context_tests() {
+    ed_context *context = ed_context_create();
+
+    printf("--- Running ed_context tests ---\n");
+    printf("edit_distance_ctx(\"passato\", \"pioppo\") = %d (expected 9)\n", edit_distance_ctx(context, "passato", "pioppo"));
+    printf("edit_distance_ctx(\"casa\", \"cassa\") = %d (expected 1)\n", edit_distance_ctx(context, "casa", "cassa"));
+    printf("edit_distance_dyn_ctx(\"tassa\", \"passato\") = %d (expected 4)\n", edit_distance_dyn_ctx(context, "tassa", "passato"));
+    printf("edit_distance_dyn_ctx(\"casa\", \"\") = %d (expected 4)\n", edit_distance_dyn_ctx(context, "casa", ""));
+    printf("edit_distance_dyn_ctx(\"vinaio\", \"vino\") = %d (expected 2)\n", edit_distance_dyn_ctx(context, "vinaio", "vino"));
+    printf("edit_distance_bounded_ctx(\"tassa\", \"passato\", 3) = %d (expected 4)\n", edit_distance_bounded_ctx(context, "tassa", "passato", 3));
+    printf("edit_distance_bounded_ctx(\"casa\", \"cassa\", 1) = %d (expected 1)\n", edit_distance_bounded_ctx(context, "casa", "cassa", 1));
+    printf("ed_context calls = %lld (expected 7), cutoffs = %lld (expected 1)\n", context->calls, context->cutoffs);
+
+    ed_context_free(context);
+}
+
+/**
+ * @brief Runs tests for the q-gram index search.
+ * 
+ * This function indexes a small dictionary of longer terms and searches misspelled queries,
+ * both through the count filter and through the lengths it cannot handle, checking the
+ * ties are resolved in dictionary order as in the linear search.
+ */
+void run_qgram_index_tests() {
+    char *dictionary[] = {"passatoio", "pioppeto", "casale", "casato", "vinaio", "pane"};
+    qgram_index *index = qgram_index_build(dictionary, 6, 2);
+    qgram_scratch *scratch = qgram_scratch_create(index);
+    ed_context *context = ed_context_create();
+    int distance;
+
+    printf("--- Running qgram_index tests ---\n");
+    printf("qgram_index_build(q = 9) = %p (expected (nil))\n", (void *)qgram_index_build(dictionary, 6, 9));
+    printf("qgram_index_find_closest(\"pasatoio\", 2) = %d", qgram_index_find_closest(index, "pasatoio", 2, scratch, context, &distance));
+    printf(", distance %d (expected 0, distance 1)\n", distance);
+    printf("qgram_index_find_closest(\"pioppetto\", 1) = %d", qgram_index_find_closest(index, "pioppetto", 1, scratch, context, &distance));
+    printf(", distance %d (expected 1, distance 1)\n", distance);
+    printf("qgram_index_find_closest(\"casalo\", 2) = %d", qgram_index_find_closest(index, "casalo", 2, scratch, context, &distance));
+    printf(", distance %d (expected 2, distance 2)\n", distance);
+    printf("qgram_index_find_closest(\"pan\", 2) = %d", qgram_index_find_closest(index, "pan", 2, scratch, context, &distance));
+    printf(", distance %d (expected 5, distance 1)\n", distance);
+    printf("qgram_index_find_closest(\"tortellino\", 2) = %d", qgram_index_find_closest(index, "tortellino", 2, scratch, context, &distance));
+    printf(", distance %d (expected -1, distance -1)\n", distance);
+
+    ed_context_free(context);
+    qgram_scratch_free(scratch);
+    qgram_index_free(index);
+}
+
+/**
+ * @brief Runs tests for the dictionary set and the Bloom filter in front of it.
+ * 
+ * This function checks case-insensitive membership in the set, then fills a Bloom filter
+ * with numbered keys and measures its false positives on keys that were not added.
+ */
+void run_membership_tests() {
+    char *dictionary[] = {"casa", "Vino", "pane", "CASA"};
+    word_set *set = word_set_build(dictionary, 4);
+
+    printf("--- Running membership tests ---\n");
+    printf("word_set count = %d (expected 3)\n", set->count);
+    printf("word_set_contains(\"Casa\") = %d (expected 1)\n", word_set_contains(set, "Casa", word_set_hash("Casa")));
+    printf("word_set_contains(\"vino\") = %d (expected 1)\n", word_set_contains(set, "vino", word_set_hash("vino")));
+    printf("word_set_contains(\"cassa\") = %d (expected 0)\n", word_set_contains(set, "cassa", word_set_hash("cassa")));
+    word_set_free(set);
+
+    bloom_filter *filter = bloom_filter_create(1000, 0.01, 0);
+    char key[32];
+    int missing = 0, false_positives = 0;
+    for (int i = 0; i < 1000; ++i) {
+        sprintf(key, "parola%d", i);
+        bloom_filter_add(filter, word_set_hash(key));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        sprintf(key, "parola%d", i);
+        missing += !bloom_filter_may_contain(filter, word_set_hash(key));
+    }
+    for (int i = 1000; i < 11000; ++i) {
+        sprintf(key, "parola%d", i);
+        false_positives += bloom_filter_may_contain(filter, word_set_hash(key));
+    }
+    printf("bloom_filter added keys missing = %d (expected 0)\n", missing);
+    printf("bloom_filter false positives below 3%% = %d (expected 1)\n", false_positives < 300);
+    bloom_filter_free(filter);
+}
+
+/**
+ * @brief Runs tests for the `find_closest_words` function.
+ * 
+ * This function checks a small batch with a repeated word, then a batch spanning several
+ * query tiles against a dictionary spanning several blocks and decoded by the caller,
+ * comparing every answer with a scan of the dictionary that keeps the first word at the smallest distance.
+ */
+void run_batch_search_tests() {
+    char *dictionary[] = {"casa", "cassa", "vino", "pane"};
+    char *queries[] = {"cas", "vinaio", "cas", "pioppo"};
+    char *results[4];
+    printf("--- Running find_closest_words tests ---\n");
+    int distinct = find_closest_words(queries, 4, dictionary, 4, NULL, 2, 2, results, NULL, NULL);
+    printf("find_closest_words distinct queries = %d (expected 3)\n", distinct);
+    printf("find_closest_words(\"cas\") = %s (expected casa)\n", results[0] ? results[0] : "NULL");
+    printf("find_closest_words(\"vinaio\") = %s (expected vino)\n", results[1] ? results[1] : "NULL");
+    printf("find_closest_words(\"cas\", repeated) = %s (expected casa)\n", results[2] ? results[2] : "NULL");
+    printf("find_closest_words(\"pioppo\") = %s (expected NULL)\n", results[3] ? results[3] : "NULL");
+
+    int dict_size = 3 * BATCH_DICT_TILE + 5, nqueries = 3 * BATCH_QUERY_TILE + 7;
+    char **words = malloc((size_t)dict_size * sizeof(char *));
+    char **batch = malloc((size_t)nqueries * sizeof(char *));
+    char **closest = malloc((size_t)nqueries * sizeof(char *));
+    srand(3);
+    for (int w = 0; w < dict_size; ++w) {
+        int length = 3 + rand() % 6;
+        words[w] = malloc((size_t)length + 1);
+        for (int i = 0; i < length; ++i) words[w][i] = (char)('a' + rand() % 4);
+        words[w][length] = '\0';
+    }
+    for (int q = 0; q < nqueries; ++q) {
+        const char *word = (q % 3 == 0) ? words[rand() % 50] : words[rand() % dict_size]; // Some repeat
+        batch[q] = malloc(strlen(word) + 2);
+        strcpy(batch[q], word);
+        if (q % 2) strcat(batch[q], "d"); // Not in the dictionary
+    }
+    utf8_words *decoded = utf8_words_decode(words, dict_size);
+    find_closest_words(batch, nqueries, words, dict_size, decoded, 2, 3, closest, NULL, NULL);
+    utf8_words_free(decoded);
+    int mismatches = 0;
+    for (int q = 0; q < nqueries; ++q) {
+        char *expected = NULL;
+        int best = 3;
+        for (int w = 0; w < dict_size; ++w) {
+            int dist = edit_distance_dyn(batch[q], words[w]);
+            if (dist < best) {
+                best = dist;
+                expected = words[w];
+            }
+        }
+        mismatches += (closest[q] != expected);
+    }
+    printf("find_closest_words mismatches with the linear scan = %d (expected 0)\n", mismatches);
+    for (int q = 0; q < nqueries; ++q) free(batch[q]);
+    for (int w = 0; w < dict_size; ++w) free(words[w]);
+    free(closest);
+    free(batch);
+    free(words);
+}
+
+/**
+ * @brief Runs tests for the UTF-8 helpers and the code point kernels.
+ * 
+ * This function checks the ASCII test across word boundaries, the decoding of valid and
+ * invalid sequences, and that accented letters count as one character both for the
+ * distance and for the q-gram index.
+ */
+void run_utf8_tests() {
+    unsigned int codepoints[16];
+    printf("--- Running UTF-8 tests ---\n");
+    printf("utf8_is_ascii(\"precipitevolissimevolmente\") = %d (expected 1)\n",
+           utf8_is_ascii("precipitevolissimevolmente", 26));
+    printf("utf8_is_ascii(\"precipitevolissimevolment\\u00e8\") = %d (expected 0)\n",
+           utf8_is_ascii("precipitevolissimevolment\xc3\xa8", 27));
+    printf("utf8_decode(\"citt\\u00e0\") = %d (expected 5)\n", utf8_decode("citt\xc3\xa0", codepoints));
+    printf("utf8_decode(\"citt\\u00e0\") last code point = %x (expected e0)\n", codepoints[4]);
+    printf("utf8_decode(overlong \"/\") = %d (expected 2)\n", utf8_decode("\xc0\xaf", codepoints));
+    printf("utf8_decode(overlong \"/\") first code point = %x (expected fffd)\n", codepoints[0]);
+    printf("utf8_is_letter(\\u00e8) = %d (expected 1)\n", utf8_is_letter(0xe8));
+    printf("utf8_is_letter(\\u00ab) = %d (expected 0)\n", utf8_is_letter(0xab));
+
+    ed_context *context = ed_context_create();
+    printf("edit_distance_utf8_ctx(\"citt\\u00e0\", \"citta\", 2) = %d (expected 2)\n",
+           edit_distance_utf8_ctx(context, "citt\xc3\xa0", "citta", 2));
+    printf("edit_distance_bounded(\"citt\\u00e0\", \"citta\", 4) = %d (expected 3)\n",
+           edit_distance_bounded("citt\xc3\xa0", "citta", 4));
+    printf("edit_distance_utf8_ctx(\"perch\\u00e9\", \"perch\\u00e8\", 2) = %d (expected 2)\n",
+           edit_distance_utf8_ctx(context, "perch\xc3\xa9", "perch\xc3\xa8", 2));
+
+    char *dictionary[] = {"casa", "citt\xc3\xa0", "perch\xc3\xa9", "pi\xc3\xb9"};
+    qgram_index *index = qgram_index_build(dictionary, 4, 2);
+    qgram_scratch *scratch = qgram_scratch_create(index);
+    int distance;
+    int id = qgram_index_find_closest(index, "citta", 2, scratch, context, &distance);
+    printf("qgram_index_find_closest(\"citta\") = %d at %d (expected 1 at 2)\n", id, distance);
+    id = qgram_index_find_closest(index, "perche", 2, scratch, context, &distance);
+    printf("qgram_index_find_closest(\"perche\") = %d at %d (expected 2 at 2)\n", id, distance);
+    qgram_scratch_free(scratch);
+    qgram_index_free(index);
+    ed_context_free(context);
+}
+
 /**
  * @brief Main function to execute all tests.
  * 
@@ -47,5 +529,18 @@ void run_edit_distance_dyn_tests() {
 int main() {
     run_edit_distance_tests();
     run_edit_distance_dyn_tests();
+    run_myers_diff_tests();
+    run_line_diff_tests();
+    run_edit_distance_bounded_tests();
+    run_edit_distance_diagonal_tests();
+    run_similarity_join_tests();
+    run_automaton_tests();
+    run_edit_distance_wavefront_tests();
+    run_ed_cursor_tests();
+    run_ed_context_tests();
+    run_qgram_index_tests();
+    run_membership_tests();
+    run_batch_search_tests();
+    run_utf8_tests();
     return 0;
 }
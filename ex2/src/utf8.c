@@ -0,0 +1,197 @@
+#include "utf8.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UTF8_HIGH_BITS 0x8080808080808080ULL // High bit of each byte of a 64-bit word
+
+/**
+ * @brief Checks whether a run of bytes is all ASCII.
+ *
+ * Whole words are loaded with `memcpy`, which compiles to a single load and makes no
+ * assumption on the alignment of `s`; the tail is checked byte by byte.
+ *
+ * @param s Pointer to the bytes.
+ * @param length Number of bytes.
+ * @return Non-zero value if no byte has the high bit set, zero otherwise.
+ */
+int utf8_is_ascii(const char *s, size_t length) {
+    size_t i = 0;
+    unsigned long long bits = 0;
+    for (; i + 8 <= length; i += 8) {
+        unsigned long long word;
+        memcpy(&word, s + i, sizeof(word));
+        bits |= word;
+    }
+    for (; i < length; ++i) {
+        bits |= (unsigned char)s[i];
+    }
+    return (bits & UTF8_HIGH_BITS) == 0;
+}
+
+/**
+ * @brief Decodes the UTF-8 sequence starting at a byte.
+ *
+ * @param s Pointer to the first byte of the sequence.
+ * @param codepoint Output code point.
+ * @return The number of bytes consumed.
+ */
+int utf8_decode_char(const char *s, unsigned int *codepoint) {
+    const unsigned char *u = (const unsigned char *)s;
+    unsigned int c = u[0];
+    int n;
+    unsigned int min;
+
+    if (c < 0x80) {
+        *codepoint = c;
+        return 1;
+    } else if ((c & 0xe0) == 0xc0) {
+        n = 2;
+        min = 0x80;
+        c &= 0x1f;
+    } else if ((c & 0xf0) == 0xe0) {
+        n = 3;
+        min = 0x800;
+        c &= 0x0f;
+    } else if ((c & 0xf8) == 0xf0) {
+        n = 4;
+        min = 0x10000;
+        c &= 0x07;
+    } else {
+        *codepoint = UTF8_REPLACEMENT; // Continuation byte or invalid lead byte
+        return 1;
+    }
+
+    for (int i = 1; i < n; ++i) {
+        if ((u[i] & 0xc0) != 0x80) { // Also stops at the terminator
+            *codepoint = UTF8_REPLACEMENT;
+            return 1;
+        }
+        c = (c << 6) | (u[i] & 0x3f);
+    }
+    if (c < min || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff)) {
+        *codepoint = UTF8_REPLACEMENT;
+        return 1;
+    }
+    *codepoint = c;
+    return n;
+}
+
+/**
+ * @brief Decodes a string into code points.
+ *
+ * @param s Pointer to the string.
+ * @param codepoints Output array.
+ * @return The number of code points.
+ */
+int utf8_decode(const char *s, unsigned int *codepoints) {
+    int n = 0;
+    while (*s) {
+        s += utf8_decode_char(s, &codepoints[n++]);
+    }
+    return n;
+}
+
+/**
+ * @brief Checks whether a code point is a letter.
+ *
+ * @param codepoint Code point to check.
+ * @return Non-zero value if the code point is a letter, zero otherwise.
+ */
+int utf8_is_letter(unsigned int codepoint) {
+    if (codepoint < 0x80) {
+        return (codepoint >= 'a' && codepoint <= 'z') || (codepoint >= 'A' && codepoint <= 'Z');
+    }
+    if (codepoint == 0xd7 || codepoint == 0xf7) {
+        return 0; // Multiplication and division signs
+    }
+    return (codepoint >= 0xc0 && codepoint <= 0x24f) ||    // Latin-1 letters, Latin Extended-A and B
+           (codepoint >= 0x370 && codepoint <= 0x3ff && codepoint != 0x37e && codepoint != 0x387) || // Greek
+           (codepoint >= 0x400 && codepoint <= 0x52f) ||   // Cyrillic
+           (codepoint >= 0x1e00 && codepoint <= 0x1eff);   // Latin Extended Additional
+}
+
+/**
+ * @brief Decodes the non-ASCII words of a list.
+ *
+ * A first pass measures the words and finds the non-ASCII ones, so that their code points
+ * fit in one allocation, filled by the second pass.
+ *
+ * @param words Array of pointers to the words.
+ * @param nwords Number of words.
+ * @return Pointer to the decoded words.
+ */
+utf8_words *utf8_words_decode(char **words, int nwords) {
+    utf8_words *decoded = malloc(sizeof(utf8_words));
+    if (!decoded) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    decoded->lengths = malloc(((size_t)nwords + 1) * sizeof(int));
+    decoded->start = malloc(((size_t)nwords + 1) * sizeof(int));
+    if (!decoded->lengths || !decoded->start) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    decoded->max_length = 0;
+
+    size_t total = 0;
+    for (int id = 0; id < nwords; ++id) {
+        size_t bytes = strlen(words[id]);
+        if (utf8_is_ascii(words[id], bytes)) {
+            decoded->lengths[id] = (int)bytes;
+            decoded->start[id] = -1;
+        } else {
+            decoded->start[id] = (int)total;
+            total += bytes; // An upper bound of the code points, fixed by the second pass
+        }
+    }
+
+    decoded->codepoints = malloc((total + 1) * sizeof(unsigned int));
+    if (!decoded->codepoints) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    int used = 0;
+    for (int id = 0; id < nwords; ++id) {
+        if (decoded->start[id] >= 0) {
+            decoded->start[id] = used;
+            decoded->lengths[id] = utf8_decode(words[id], decoded->codepoints + used);
+            used += decoded->lengths[id];
+        }
+        if (decoded->lengths[id] > decoded->max_length) decoded->max_length = decoded->lengths[id];
+    }
+    return decoded;
+}
+
+/**
+ * @brief Frees the memory held by decoded words.
+ *
+ * @param decoded Pointer to the decoded words.
+ */
+void utf8_words_free(utf8_words *decoded) {
+    if (!decoded) return;
+    free(decoded->lengths);
+    free(decoded->start);
+    free(decoded->codepoints);
+    free(decoded);
+}
+
+/**
+ * @brief Returns the code points of a word of a decoded list.
+ *
+ * @param decoded Pointer to the decoded words.
+ * @param words Array of pointers to the words the list was decoded from.
+ * @param id Position of the word.
+ * @param buffer Room for the code points of an ASCII word.
+ * @return Pointer to the code points of the word.
+ */
+const unsigned int *utf8_words_codepoints(const utf8_words *decoded, char **words, int id, unsigned int *buffer) {
+    if (decoded->start[id] >= 0) {
+        return decoded->codepoints + decoded->start[id];
+    }
+    for (int i = 0; i < decoded->lengths[id]; ++i) {
+        buffer[i] = (unsigned char)words[id][i];
+    }
+    return buffer;
+}
@@ -0,0 +1,91 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <stddef.h>
+
+#define UTF8_REPLACEMENT 0xFFFDu // Code point given to the bytes of invalid sequences
+
+/**
+ * @brief Code points of a list of words, decoded once.
+ *
+ * ASCII words are left to the byte-level kernels and are not copied: only the words with
+ * a non-ASCII character are decoded, one after another, into a single array.
+ */
+typedef struct {
+    int *lengths;                // Length of each word in code points
+    int *start;                  // Start of each word in `codepoints`, -1 for ASCII words
+    unsigned int *codepoints;    // Code points of the non-ASCII words
+    int max_length;              // Longest word, in code points
+} utf8_words;
+
+/**
+ * @brief Checks whether a run of bytes is all ASCII.
+ *
+ * The bytes are tested eight at a time, with one mask per 64-bit word.
+ *
+ * @param s Pointer to the bytes.
+ * @param length Number of bytes.
+ * @return Non-zero value if no byte has the high bit set, zero otherwise.
+ */
+int utf8_is_ascii(const char *s, size_t length);
+
+/**
+ * @brief Decodes the UTF-8 sequence starting at a byte.
+ *
+ * Overlong forms, surrogates, values past U+10FFFF and truncated sequences are invalid:
+ * their first byte decodes to `UTF8_REPLACEMENT` and decoding resumes at the next byte.
+ *
+ * @param s Pointer to the first byte of the sequence, which must not be the terminator.
+ * @param codepoint Output code point.
+ * @return The number of bytes consumed, from 1 to 4.
+ */
+int utf8_decode_char(const char *s, unsigned int *codepoint);
+
+/**
+ * @brief Decodes a string into code points.
+ *
+ * @param s Pointer to the string.
+ * @param codepoints Output array, with room for at least `strlen(s)` code points.
+ * @return The number of code points.
+ */
+int utf8_decode(const char *s, unsigned int *codepoints);
+
+/**
+ * @brief Checks whether a code point is a letter.
+ *
+ * Letters are the ASCII ones and those of the Latin, Greek and Cyrillic blocks, which
+ * cover the accented letters of the European languages; signs such as `×` and `÷` are not.
+ *
+ * @param codepoint Code point to check.
+ * @return Non-zero value if the code point is a letter, zero otherwise.
+ */
+int utf8_is_letter(unsigned int codepoint);
+
+/**
+ * @brief Decodes the non-ASCII words of a list.
+ *
+ * @param words Array of pointers to the words; they must outlive the result.
+ * @param nwords Number of words.
+ * @return Pointer to the decoded words.
+ */
+utf8_words *utf8_words_decode(char **words, int nwords);
+
+/**
+ * @brief Frees the memory held by decoded words.
+ *
+ * @param decoded Pointer to the decoded words.
+ */
+void utf8_words_free(utf8_words *decoded);
+
+/**
+ * @brief Returns the code points of a word of a decoded list.
+ *
+ * @param decoded Pointer to the decoded words.
+ * @param words Array of pointers to the words the list was decoded from.
+ * @param id Position of the word.
+ * @param buffer Room for the code points of an ASCII word, which are widened there.
+ * @return Pointer to the `decoded->lengths[id]` code points of the word.
+ */
+const unsigned int *utf8_words_codepoints(const utf8_words *decoded, char **words, int id, unsigned int *buffer);
+
+#endif // UTF8_H
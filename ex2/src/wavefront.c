@@ -0,0 +1,210 @@
+#include "wavefront.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Data shared by the threads computing the table.
+ *
+ * `top[c]` holds the value of column `c` in the last row computed so far for that column,
+ * `left[r]` the value of row `r` in the last column computed so far for that row, and
+ * `corners` the values at the corners of the tile grid, each written once.
+ */
+typedef struct {
+    const char *s1;
+    const char *s2;
+    int len1;
+    int len2;
+    int tile_rows;       // Number of tile rows
+    int tile_cols;       // Number of tile columns
+    int num_threads;
+    int *top;
+    int *left;
+    int *corners;
+    atomic_int *done;    // Number of tiles completed in each tile row
+} wavefront_table;
+
+/**
+ * @brief State of a worker thread.
+ */
+typedef struct {
+    wavefront_table *table;
+    int first_row;       // First tile row dealt to the thread
+} wavefront_worker;
+
+/**
+ * @brief Returns the minimum of two integers.
+ *
+ * @param a First integer.
+ * @param b Second integer.
+ * @return The smaller of the two integers.
+ */
+static int min(int a, int b) {
+    return (a < b) ? a : b;
+}
+
+/**
+ * @brief Computes one tile of the table from its boundary values.
+ *
+ * The tile covers rows `(r0, r1]` and columns `(c0, c1]`. Its top boundary is read from
+ * `top`, its left boundary from `left`, and its bottom row and right column are written
+ * back to the same arrays for the tiles below and on the right.
+ *
+ * @param table Shared table data.
+ * @param bi Tile row.
+ * @param bj Tile column.
+ * @param prev Scratch row of at least `WAVEFRONT_TILE + 1` cells.
+ * @param curr Scratch row of at least `WAVEFRONT_TILE + 1` cells.
+ */
+static void compute_tile(wavefront_table *table, int bi, int bj, int *prev, int *curr) {
+    int r0 = bi * WAVEFRONT_TILE;
+    int r1 = min(r0 + WAVEFRONT_TILE, table->len1);
+    int c0 = bj * WAVEFRONT_TILE;
+    int c1 = min(c0 + WAVEFRONT_TILE, table->len2);
+    int width = c1 - c0;
+    const char *s2 = table->s2 + c0;
+
+    prev[0] = table->corners[bi * (table->tile_cols + 1) + bj];
+    memcpy(prev + 1, table->top + c0 + 1, (size_t)width * sizeof(int));
+
+    for (int r = r0 + 1; r <= r1; ++r) {
+        char c = table->s1[r - 1];
+        curr[0] = table->left[r];
+        for (int j = 1; j <= width; ++j) {
+            if (c == s2[j - 1]) {
+                curr[j] = prev[j - 1]; // Characters match, no operation needed
+            } else {
+                curr[j] = 1 + min(prev[j],      // Delete
+                                  curr[j - 1]); // Insert
+            }
+        }
+        table->left[r] = curr[width];
+
+        int *temp = prev;
+        prev = curr;
+        curr = temp;
+    }
+
+    memcpy(table->top + c0 + 1, prev + 1, (size_t)width * sizeof(int));
+    table->corners[(bi + 1) * (table->tile_cols + 1) + bj + 1] = prev[width];
+}
+
+/**
+ * @brief Body of a worker thread: computes its tile rows from left to right.
+ *
+ * Before computing tile `(bi, bj)` the thread waits until tile `(bi - 1, bj)` is done; the
+ * tile on the left is always done, since the thread computed it itself.
+ *
+ * @param arg Pointer to the `wavefront_worker` state.
+ * @return NULL.
+ */
+static void *wavefront_worker_run(void *arg) {
+    wavefront_worker *worker = arg;
+    wavefront_table *table = worker->table;
+
+    int *rows = malloc(2 * (WAVEFRONT_TILE + 1) * sizeof(int));
+    if (!rows) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int bi = worker->first_row; bi < table->tile_rows; bi += table->num_threads) {
+        for (int bj = 0; bj < table->tile_cols; ++bj) {
+            if (bi > 0) {
+                while (atomic_load_explicit(&table->done[bi - 1], memory_order_acquire) <= bj) {
+                    sched_yield();
+                }
+            }
+            compute_tile(table, bi, bj, rows, rows + WAVEFRONT_TILE + 1);
+            atomic_store_explicit(&table->done[bi], bj + 1, memory_order_release);
+        }
+    }
+
+    free(rows);
+    return NULL;
+}
+
+/**
+ * @brief Computes the edit distance between two long strings with several threads.
+ *
+ * This function sets up the boundary arrays, with the first row and the first column of
+ * the table and the corners of the tile grid along them, then starts one worker per
+ * thread and returns the corner of the last tile.
+ *
+ * @param s1 First string.
+ * @param s2 Second string.
+ * @param num_threads Number of threads.
+ * @return The edit distance between the two strings.
+ */
+int edit_distance_wavefront(const char *s1, const char *s2, int num_threads) {
+    wavefront_table table;
+    table.s1 = s1;
+    table.s2 = s2;
+    table.len1 = (int)strlen(s1);
+    table.len2 = (int)strlen(s2);
+
+    if (table.len1 == 0 || table.len2 == 0) {
+        return table.len1 + table.len2;
+    }
+
+    table.tile_rows = (table.len1 + WAVEFRONT_TILE - 1) / WAVEFRONT_TILE;
+    table.tile_cols = (table.len2 + WAVEFRONT_TILE - 1) / WAVEFRONT_TILE;
+    table.num_threads = (num_threads < 1) ? 1 : min(num_threads, table.tile_rows);
+
+    table.top = malloc((size_t)(table.len2 + 1) * sizeof(int));
+    table.left = malloc((size_t)(table.len1 + 1) * sizeof(int));
+    table.corners = malloc((size_t)(table.tile_rows + 1) * (size_t)(table.tile_cols + 1) * sizeof(int));
+    table.done = malloc((size_t)table.tile_rows * sizeof(atomic_int));
+    if (!table.top || !table.left || !table.corners || !table.done) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int j = 0; j <= table.len2; ++j) {
+        table.top[j] = j; // If s1 is empty, all characters of s2 need to be inserted
+    }
+    for (int i = 0; i <= table.len1; ++i) {
+        table.left[i] = i; // If s2 is empty, all characters of s1 need to be deleted
+    }
+    for (int bj = 0; bj <= table.tile_cols; ++bj) {
+        table.corners[bj] = min(bj * WAVEFRONT_TILE, table.len2);
+    }
+    for (int bi = 0; bi <= table.tile_rows; ++bi) {
+        table.corners[bi * (table.tile_cols + 1)] = min(bi * WAVEFRONT_TILE, table.len1);
+    }
+    for (int bi = 0; bi < table.tile_rows; ++bi) {
+        atomic_init(&table.done[bi], 0);
+    }
+
+    pthread_t *threads = malloc((size_t)table.num_threads * sizeof(pthread_t));
+    wavefront_worker *workers = malloc((size_t)table.num_threads * sizeof(wavefront_worker));
+    if (!threads || !workers) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int t = 0; t < table.num_threads; ++t) {
+        workers[t].table = &table;
+        workers[t].first_row = t;
+        if (pthread_create(&threads[t], NULL, wavefront_worker_run, &workers[t]) != 0) {
+            perror("Error creating worker thread");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int t = 0; t < table.num_threads; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    int distance = table.corners[table.tile_rows * (table.tile_cols + 1) + table.tile_cols];
+
+    free(workers);
+    free(threads);
+    free(table.done);
+    free(table.corners);
+    free(table.left);
+    free(table.top);
+    return distance;
+}
@@ -0,0 +1,24 @@
+#ifndef WAVEFRONT_H
+#define WAVEFRONT_H
+
+#define WAVEFRONT_TILE 2048 // Side of the square tiles of the dynamic programming table
+
+/**
+ * @brief Computes the edit distance between two long strings with several threads.
+ *
+ * The dynamic programming table is cut into `WAVEFRONT_TILE` x `WAVEFRONT_TILE` tiles, and
+ * tiles on the same anti-diagonal are computed in parallel. Each tile only needs the last
+ * row of the tile above, the last column of the tile on its left and one corner value, so
+ * the table is never stored: only one row and one column of boundary values are kept for
+ * the whole table, plus two rows of the tile being computed. Tile rows are dealt to the
+ * threads in turn, and a thread starts a tile as soon as the tile above is published in the
+ * progress counter of its row; no barrier is shared by all the threads.
+ *
+ * @param s1 Pointer to the first string.
+ * @param s2 Pointer to the second string.
+ * @param num_threads Number of threads (values below 1 are treated as 1).
+ * @return The edit distance between the two strings.
+ */
+int edit_distance_wavefront(const char *s1, const char *s2, int num_threads);
+
+#endif // WAVEFRONT_H
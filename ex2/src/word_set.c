@@ -0,0 +1,92 @@
+#include "word_set.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+/**
+ * @brief Computes the case-folded 64-bit FNV-1a hash of a word.
+ *
+ * @param word Pointer to the word.
+ * @return The hash of the word folded to lower case.
+ */
+unsigned long long word_set_hash(const char *word) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (const unsigned char *c = (const unsigned char *)word; *c; ++c) {
+        hash ^= (unsigned long long)tolower(*c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Builds the set of a list of words.
+ *
+ * The table is kept at most half full. Words equal up to case are stored once.
+ *
+ * @param words Array of pointers to the words.
+ * @param nwords Number of words.
+ * @return Pointer to the new set.
+ */
+word_set *word_set_build(char **words, int nwords) {
+    word_set *set = malloc(sizeof(word_set));
+    if (!set) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+
+    set->capacity = 16;
+    while (set->capacity < 2 * (size_t)nwords) set->capacity <<= 1;
+    set->words = calloc(set->capacity, sizeof(char *));
+    set->hashes = malloc(set->capacity * sizeof(unsigned long long));
+    if (!set->words || !set->hashes) {
+        perror("Memory allocation error");
+        exit(EXIT_FAILURE);
+    }
+    set->count = 0;
+
+    for (int i = 0; i < nwords; ++i) {
+        unsigned long long hash = word_set_hash(words[i]);
+        size_t slot = (size_t)hash & (set->capacity - 1);
+        while (set->words[slot] && !(set->hashes[slot] == hash && strcasecmp(set->words[slot], words[i]) == 0)) {
+            slot = (slot + 1) & (set->capacity - 1);
+        }
+        if (!set->words[slot]) {
+            set->words[slot] = words[i];
+            set->hashes[slot] = hash;
+            set->count++;
+        }
+    }
+    return set;
+}
+
+/**
+ * @brief Checks whether a word is in the set, ignoring case.
+ *
+ * @param set Pointer to the set.
+ * @param word Word to look up.
+ * @param hash Hash of the word, as computed by `word_set_hash`.
+ * @return 1 if the word is in the set, 0 otherwise.
+ */
+int word_set_contains(const word_set *set, const char *word, unsigned long long hash) {
+    size_t slot = (size_t)hash & (set->capacity - 1);
+    while (set->words[slot]) {
+        if (set->hashes[slot] == hash && strcasecmp(set->words[slot], word) == 0) {
+            return 1;
+        }
+        slot = (slot + 1) & (set->capacity - 1);
+    }
+    return 0;
+}
+
+/**
+ * @brief Frees the memory held by a set.
+ *
+ * @param set Pointer to the set.
+ */
+void word_set_free(word_set *set) {
+    if (!set) return;
+    free(set->words);
+    free(set->hashes);
+    free(set);
+}
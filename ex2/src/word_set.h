@@ -0,0 +1,54 @@
+#ifndef WORD_SET_H
+#define WORD_SET_H
+
+#include <stddef.h>
+
+/**
+ * @brief Case-insensitive hash set of the dictionary words.
+ *
+ * Words are hashed after folding them to lower case, and the slots of the open-addressing
+ * table keep the hash next to the word, so that a probe compares strings only when the
+ * hashes are equal. The words themselves are not copied.
+ */
+typedef struct {
+    char **words;                  // Word of each slot, NULL if the slot is empty
+    unsigned long long *hashes;    // Hash of the word of each slot
+    size_t capacity;               // Number of slots, a power of two
+    int count;                     // Number of distinct words
+} word_set;
+
+/**
+ * @brief Computes the case-folded 64-bit FNV-1a hash of a word.
+ *
+ * @param word Pointer to the word.
+ * @return The hash of the word folded to lower case.
+ */
+unsigned long long word_set_hash(const char *word);
+
+/**
+ * @brief Builds the set of a list of words.
+ *
+ * @param words Array of pointers to the words; they must outlive the set.
+ * @param nwords Number of words.
+ * @return Pointer to the new set.
+ */
+word_set *word_set_build(char **words, int nwords);
+
+/**
+ * @brief Checks whether a word is in the set, ignoring case.
+ *
+ * @param set Pointer to the set.
+ * @param word Word to look up.
+ * @param hash Hash of the word, as computed by `word_set_hash`.
+ * @return 1 if the word is in the set, 0 otherwise.
+ */
+int word_set_contains(const word_set *set, const char *word, unsigned long long hash);
+
+/**
+ * @brief Frees the memory held by a set.
+ *
+ * @param set Pointer to the set.
+ */
+void word_set_free(word_set *set);
+
+#endif // WORD_SET_H
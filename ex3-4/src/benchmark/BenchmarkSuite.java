@@ -0,0 +1,172 @@
+package benchmark;
+
+import graph.Graph;
+import graph.Prim;
+import priorityqueue.IndexedDoublePriorityQueue;
+import priorityqueue.PriorityQueue;
+import java.io.FileNotFoundException;
+import java.io.PrintStream;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Comparator;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Random;
+
+/**
+ * Runs the benchmarks of the priority queues and of Prim's algorithm on the {@link Harness} and
+ * writes the results as JSON, for tracking regressions between versions.
+ * <p>
+ * Heap operations are measured on 1K to 10M elements, and the Minimum Spanning Forest on random
+ * connected graphs of 1K to 100K nodes. The options are:
+ * <ul>
+ *   <li>{@code --out=FILE}: write the JSON to a file instead of the standard output;</li>
+ *   <li>{@code --sizes=N,...}: the numbers of elements of the heap benchmarks;</li>
+ *   <li>{@code --graph-sizes=N,...}: the numbers of nodes of the graph benchmarks;</li>
+ *   <li>{@code --warmup=N}, {@code --iterations=N}, {@code --time-ms=N}: the iteration settings of the harness.</li>
+ * </ul>
+ * The largest heaps need a few gigabytes of memory, so the make target raises the JVM heap size.
+ */
+public class BenchmarkSuite {
+    private static final int[] SIZES = {1_000, 10_000, 100_000, 1_000_000, 10_000_000};
+    private static final int[] GRAPH_SIZES = {1_000, 10_000, 100_000};
+    private static final int WARMUP_ITERATIONS = 3;
+    private static final int ITERATIONS = 5;
+    private static final long ITERATION_MILLIS = 200;
+
+    /**
+     * Parses a comma-separated list of positive sizes.
+     *
+     * @param value the list
+     * @return the sizes
+     * @throws IllegalArgumentException if a size is not a positive integer
+     */
+    private static int[] parseSizes(String value) {
+        int[] sizes = Arrays.stream(value.split(",")).mapToInt(s -> Integer.parseInt(s.trim())).toArray();
+        for (int size : sizes) {
+            if (size < 1) {
+                throw new IllegalArgumentException("Sizes must be positive.");
+            }
+        }
+        return sizes;
+    }
+
+    /**
+     * Builds the parameters of a benchmark run.
+     *
+     * @param keysAndValues the names and values of the parameters, alternating
+     * @return the parameters, in the given order
+     */
+    private static Map<String, String> params(Object... keysAndValues) {
+        Map<String, String> params = new LinkedHashMap<>();
+        for (int i = 0; i + 1 < keysAndValues.length; i += 2) {
+            params.put(String.valueOf(keysAndValues[i]), String.valueOf(keysAndValues[i + 1]));
+        }
+        return params;
+    }
+
+    /**
+     * Pushes the ids {@code 0} to {@code n - 1} into an {@link IndexedDoublePriorityQueue} and pops them all.
+     *
+     * @param keys the keys of the ids
+     * @param n the number of ids
+     * @return the sum of the popped ids
+     */
+    private static long indexedFillDrain(double[] keys, int n) {
+        IndexedDoublePriorityQueue queue = new IndexedDoublePriorityQueue(n);
+        for (int i = 0; i < n; i++) {
+            queue.push(i, keys[i]);
+        }
+        long checksum = 0;
+        while (!queue.empty()) {
+            checksum += queue.top();
+            queue.pop();
+        }
+        return checksum;
+    }
+
+    /**
+     * Runs the suite.
+     *
+     * @param args the options described in the class documentation
+     */
+    public static void main(String[] args) {
+        String out = null;
+        int[] sizes = SIZES;
+        int[] graphSizes = GRAPH_SIZES;
+        int warmup = WARMUP_ITERATIONS;
+        int iterations = ITERATIONS;
+        long iterationMillis = ITERATION_MILLIS;
+        for (String arg : args) {
+            if (arg.startsWith("--out=")) {
+                out = arg.substring("--out=".length());
+            } else if (arg.startsWith("--sizes=")) {
+                sizes = parseSizes(arg.substring("--sizes=".length()));
+            } else if (arg.startsWith("--graph-sizes=")) {
+                graphSizes = parseSizes(arg.substring("--graph-sizes=".length()));
+            } else if (arg.startsWith("--warmup=")) {
+                warmup = Integer.parseInt(arg.substring("--warmup=".length()));
+            } else if (arg.startsWith("--iterations=")) {
+                iterations = Integer.parseInt(arg.substring("--iterations=".length()));
+            } else if (arg.startsWith("--time-ms=")) {
+                iterationMillis = Long.parseLong(arg.substring("--time-ms=".length()));
+            } else {
+                System.err.println("Usage: java benchmark.BenchmarkSuite [--out=FILE] [--sizes=N,...] [--graph-sizes=N,...]"
+                                   + " [--warmup=N] [--iterations=N] [--time-ms=N]");
+                return;
+            }
+        }
+        Harness harness = new Harness(warmup, iterations, iterationMillis);
+        Random random = new Random(42);
+
+        int maxSize = Arrays.stream(sizes).max().getAsInt();
+        double[] keys = new double[maxSize];
+        List<Integer> elements = new ArrayList<>(maxSize);
+        for (int i = 0; i < maxSize; i++) {
+            keys[i] = random.nextDouble();
+            elements.add(i);
+        }
+        Comparator<Integer> comparator = (x, y) -> Double.compare(keys[x], keys[y]);
+
+        for (int n : sizes) {
+            List<Integer> prefix = elements.subList(0, n);
+            report(harness.run("priorityqueue.PriorityQueue.pushPop", params("size", n, "arity", 2), 2L * n,
+                               () -> HeapBenchmark.popHeavy(new PriorityQueue<>(comparator), n)));
+            report(harness.run("priorityqueue.PriorityQueue.pushPop", params("size", n, "arity", 4), 2L * n,
+                               () -> HeapBenchmark.popHeavy(new PriorityQueue<>(comparator, 4), n)));
+            report(harness.run("priorityqueue.PriorityQueue.pushHeavy", params("size", n, "arity", 2), 2L * n,
+                               () -> HeapBenchmark.pushHeavy(new PriorityQueue<>(comparator), n)));
+            report(harness.run("priorityqueue.PriorityQueue.bulkBuild", params("size", n), n,
+                               () -> new PriorityQueue<>(prefix, comparator).top()));
+            report(harness.run("priorityqueue.IndexedDoublePriorityQueue.pushPop", params("size", n), 2L * n,
+                               () -> indexedFillDrain(keys, n)));
+        }
+
+        for (int nodes : graphSizes) {
+            Graph<Integer, Integer> graph = HeapBenchmark.randomGraph(nodes, false, random);
+            report(harness.run("graph.Prim.minimumSpanningForest", params("nodes", nodes, "edges", graph.numEdges()), 1,
+                               () -> Prim.minimumSpanningForest(graph).size()));
+        }
+
+        if (out == null) {
+            harness.writeJson(System.out);
+        } else {
+            try (PrintStream stream = new PrintStream(out)) {
+                harness.writeJson(stream);
+            } catch (FileNotFoundException e) {
+                System.err.println("Error: Unable to write to output file.");
+                e.printStackTrace();
+            }
+        }
+    }
+
+    /**
+     * Prints a result on the standard error, as progress while the suite runs.
+     *
+     * @param result the result
+     */
+    private static void report(Harness.Result result) {
+        System.err.printf("%s %s: %.1f +/- %.1f ns/op%n", result.getBenchmark(), result.getParams(), result.score(), result.scoreError());
+    }
+}
@@ -0,0 +1,202 @@
+package benchmark;
+
+import java.io.PrintStream;
+import java.util.ArrayList;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Locale;
+import java.util.Map;
+import java.util.function.LongSupplier;
+
+/**
+ * A small benchmark harness in the style of JMH, measuring the average time per operation.
+ * <p>
+ * Each benchmark runs a number of warm-up iterations, whose times are discarded so that the
+ * JIT compiler can settle, and then the measured iterations. An iteration calls the benchmark
+ * repeatedly until it has run for at least the iteration time, at least once, so benchmarks
+ * of a few microseconds are timed over many calls and long ones over a single call. The
+ * results are written as a JSON array whose entries follow the layout of the JMH JSON output,
+ * so that the same tools can track them for regressions.
+ */
+public class Harness {
+    private static volatile long sink; // Receives the checksums, so that no work can be optimized away
+
+    private final int warmupIterations;
+    private final int iterations;
+    private final long iterationNanos;
+    private final List<Result> results;
+
+    /**
+     * The outcome of one benchmark with one set of parameters.
+     */
+    public static final class Result {
+        private final String benchmark;
+        private final Map<String, String> params;
+        private final double[] scores; // Nanoseconds per operation of each measured iteration
+
+        private Result(String benchmark, Map<String, String> params, double[] scores) {
+            this.benchmark = benchmark;
+            this.params = params;
+            this.scores = scores;
+        }
+
+        /**
+         * Returns the name of the benchmark.
+         *
+         * @return the name
+         */
+        public String getBenchmark() {
+            return benchmark;
+        }
+
+        /**
+         * Returns the parameters of the run.
+         *
+         * @return the parameters, in the order they are reported
+         */
+        public Map<String, String> getParams() {
+            return params;
+        }
+
+        /**
+         * Returns the mean time per operation over the measured iterations.
+         *
+         * @return the mean, in nanoseconds
+         */
+        public double score() {
+            double sum = 0;
+            for (double score : scores) {
+                sum += score;
+            }
+            return sum / scores.length;
+        }
+
+        /**
+         * Returns the half-width of the 99.9% confidence interval of the mean, with a normal approximation.
+         *
+         * @return the error, in nanoseconds, or 0 with a single iteration
+         */
+        public double scoreError() {
+            if (scores.length < 2) {
+                return 0;
+            }
+            double mean = score();
+            double squares = 0;
+            for (double score : scores) {
+                squares += (score - mean) * (score - mean);
+            }
+            return 3.291 * Math.sqrt(squares / (scores.length - 1)) / Math.sqrt(scores.length);
+        }
+    }
+
+    /**
+     * Constructs a harness.
+     *
+     * @param warmupIterations the number of iterations whose times are discarded
+     * @param iterations the number of measured iterations
+     * @param iterationMillis the least time of an iteration, in milliseconds
+     * @throws IllegalArgumentException if {@code iterations} is not positive or another argument is negative
+     */
+    public Harness(int warmupIterations, int iterations, long iterationMillis) {
+        if (warmupIterations < 0 || iterations < 1 || iterationMillis < 0) {
+            throw new IllegalArgumentException("Invalid iteration settings.");
+        }
+        this.warmupIterations = warmupIterations;
+        this.iterations = iterations;
+        this.iterationNanos = iterationMillis * 1_000_000L;
+        this.results = new ArrayList<>();
+    }
+
+    /**
+     * Runs a benchmark and records its result.
+     *
+     * @param benchmark the name of the benchmark
+     * @param params the parameters of this run, in the order they are to be reported
+     * @param operations the number of operations done by each call of the task
+     * @param task the code to be measured, returning a checksum of its work
+     * @return the result
+     */
+    public Result run(String benchmark, Map<String, String> params, long operations, LongSupplier task) {
+        double[] scores = new double[iterations];
+        for (int iteration = 0; iteration < warmupIterations + iterations; iteration++) {
+            long calls = 0;
+            long start = System.nanoTime();
+            long elapsed;
+            do {
+                sink += task.getAsLong();
+                calls++;
+                elapsed = System.nanoTime() - start;
+            } while (elapsed < iterationNanos);
+            if (iteration >= warmupIterations) {
+                scores[iteration - warmupIterations] = (double) elapsed / (calls * operations);
+            }
+        }
+        Result result = new Result(benchmark, new LinkedHashMap<>(params), scores);
+        results.add(result);
+        return result;
+    }
+
+    /**
+     * Returns the results recorded so far.
+     *
+     * @return the results, in the order they were run
+     */
+    public List<Result> getResults() {
+        return results;
+    }
+
+    /**
+     * Writes the results recorded so far as a JSON array.
+     *
+     * @param out the stream to write to
+     */
+    public void writeJson(PrintStream out) {
+        out.println("[");
+        for (int i = 0; i < results.size(); i++) {
+            Result result = results.get(i);
+            out.println("    {");
+            out.printf("        \"benchmark\" : %s,%n", quote(result.benchmark));
+            out.println("        \"mode\" : \"avgt\",");
+            out.printf("        \"warmupIterations\" : %d,%n", warmupIterations);
+            out.printf("        \"measurementIterations\" : %d,%n", iterations);
+            out.print("        \"params\" : {");
+            int param = 0;
+            for (Map.Entry<String, String> entry : result.params.entrySet()) {
+                out.printf("%s%s : %s", param++ > 0 ? ", " : " ", quote(entry.getKey()), quote(entry.getValue()));
+            }
+            out.println(param > 0 ? " }," : "},");
+            out.println("        \"primaryMetric\" : {");
+            out.printf(Locale.ROOT, "            \"score\" : %.3f,%n", result.score());
+            out.printf(Locale.ROOT, "            \"scoreError\" : %.3f,%n", result.scoreError());
+            out.println("            \"scoreUnit\" : \"ns/op\",");
+            out.print("            \"rawData\" : [ [");
+            for (int j = 0; j < result.scores.length; j++) {
+                out.printf(Locale.ROOT, "%s%.3f", j > 0 ? ", " : " ", result.scores[j]);
+            }
+            out.println(" ] ]");
+            out.println("        }");
+            out.println(i + 1 < results.size() ? "    }," : "    }");
+        }
+        out.println("]");
+    }
+
+    /**
+     * Quotes a string for JSON.
+     *
+     * @param s the string
+     * @return the string between double quotes, with quotes, backslashes and control characters escaped
+     */
+    private static String quote(String s) {
+        StringBuilder quoted = new StringBuilder("\"");
+        for (char c : s.toCharArray()) {
+            if (c == '"' || c == '\\') {
+                quoted.append('\\').append(c);
+            } else if (c < 0x20) {
+                quoted.append(String.format("\\u%04x", (int) c));
+            } else {
+                quoted.append(c);
+            }
+        }
+        return quoted.append('"').toString();
+    }
+}
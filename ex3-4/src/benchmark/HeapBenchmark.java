@@ -0,0 +1,258 @@
+package benchmark;
+
+import graph.Dijkstra;
+import graph.Graph;
+import graph.Prim;
+import priorityqueue.AbstractQueue;
+import priorityqueue.PairingHeap;
+import priorityqueue.PriorityQueue;
+import priorityqueue.RadixHeap;
+import java.util.Comparator;
+import java.util.Random;
+import java.util.function.Function;
+import java.util.function.Supplier;
+import java.util.function.ToDoubleFunction;
+
+/**
+ * Measures the throughput of the priority queues on synthetic workloads.
+ * <p>
+ * Elements are the ids {@code 0} to {@code n - 1}, ordered by random keys kept in an array, as
+ * nodes are ordered by their distance in graph algorithms. Each workload is run a few times to
+ * warm up the JIT compiler before the timed rounds, and the best round is reported.
+ */
+public class HeapBenchmark {
+    private static final int ELEMENTS = 1_000_000;
+    private static final int WARMUP_ROUNDS = 3;
+    private static final int ROUNDS = 5;
+    private static final int[] ARITIES = {2, 4, 8};
+    private static final int GRAPH_DEGREE = 8;      // Edges leaving each node of the synthetic graphs
+    private static final int MAX_EDGE_LENGTH = 100;
+    private static volatile long sink; // Receives the checksums, so that no work can be optimized away
+
+    /**
+     * A workload run on a queue, returning a checksum of the elements it popped.
+     */
+    interface Workload {
+        long run(AbstractQueue<Integer> queue, int n);
+    }
+
+    /**
+     * Pushes three elements for every pop, then drains the queue, as the edge queue of Prim's algorithm does.
+     *
+     * @param queue the empty queue to be used
+     * @param n the number of elements to be pushed
+     * @return the sum of the popped elements
+     */
+    static long pushHeavy(AbstractQueue<Integer> queue, int n) {
+        long checksum = 0;
+        for (int i = 0; i < n; i++) {
+            queue.push(i);
+            if (i % 3 == 2) {
+                checksum += queue.top();
+                queue.pop();
+            }
+        }
+        while (!queue.empty()) {
+            checksum += queue.top();
+            queue.pop();
+        }
+        return checksum;
+    }
+
+    /**
+     * Pushes all the elements, then pops them all in order, as a heap sort does.
+     *
+     * @param queue the empty queue to be used
+     * @param n the number of elements to be pushed
+     * @return the sum of the popped elements
+     */
+    static long popHeavy(AbstractQueue<Integer> queue, int n) {
+        for (int i = 0; i < n; i++) {
+            queue.push(i);
+        }
+        long checksum = 0;
+        while (!queue.empty()) {
+            checksum += queue.top();
+            queue.pop();
+        }
+        return checksum;
+    }
+
+    /**
+     * An element that counts the calls to its {@code hashCode}, one for each access of a hash map.
+     */
+    static final class CountingKey {
+        static long hashes;
+        final int id;
+
+        CountingKey(int id) {
+            this.id = id;
+        }
+
+        @Override
+        public int hashCode() {
+            hashes++;
+            return id;
+        }
+
+        @Override
+        public boolean equals(Object o) {
+            return o instanceof CountingKey && ((CountingKey) o).id == id;
+        }
+    }
+
+    /**
+     * Counts the hash map accesses of a queue on the push-heavy and the pop-heavy mix.
+     *
+     * @param factory builds an empty queue
+     * @param elements the elements to be pushed
+     * @return the accesses per element of the two mixes
+     */
+    static double[] mapTraffic(Supplier<AbstractQueue<CountingKey>> factory, CountingKey[] elements) {
+        int n = elements.length;
+        AbstractQueue<CountingKey> queue = factory.get();
+        CountingKey.hashes = 0;
+        for (int i = 0; i < n; i++) {
+            queue.push(elements[i]);
+            if (i % 3 == 2) {
+                queue.pop();
+            }
+        }
+        while (!queue.empty()) {
+            queue.pop();
+        }
+        double pushHeavy = (double) CountingKey.hashes / n;
+
+        queue = factory.get();
+        CountingKey.hashes = 0;
+        for (int i = 0; i < n; i++) {
+            queue.push(elements[i]);
+        }
+        while (!queue.empty()) {
+            queue.pop();
+        }
+        double popHeavy = (double) CountingKey.hashes / n;
+        return new double[] {pushHeavy, popHeavy};
+    }
+
+    /**
+     * Runs a task a few times and returns the best time of the timed rounds.
+     *
+     * @param task the task to be measured, returning a checksum
+     * @return the best time, in nanoseconds
+     */
+    static long measure(Supplier<Long> task) {
+        long best = Long.MAX_VALUE;
+        for (int round = 0; round < WARMUP_ROUNDS + ROUNDS; round++) {
+            long start = System.nanoTime();
+            sink += task.get();
+            long elapsed = System.nanoTime() - start;
+            if (round >= WARMUP_ROUNDS) {
+                best = Math.min(best, elapsed);
+            }
+        }
+        return best;
+    }
+
+    /**
+     * Runs a workload on fresh queues and returns the best time per element.
+     *
+     * @param workload the workload to be measured
+     * @param factory builds the empty queue of each round
+     * @param n the number of elements
+     * @return the best time per element, in nanoseconds
+     */
+    static double measure(Workload workload, Supplier<AbstractQueue<Integer>> factory, int n) {
+        return (double) measure(() -> workload.run(factory.get(), n)) / n;
+    }
+
+    /**
+     * Builds a random graph in which every node has the same number of edges leaving it, plus a
+     * path through all the nodes so that every node is reachable from node 0.
+     *
+     * @param n the number of nodes
+     * @param directed whether the graph is directed
+     * @param random the source of the edges and of their integer lengths
+     * @return the graph
+     */
+    static Graph<Integer, Integer> randomGraph(int n, boolean directed, Random random) {
+        Graph<Integer, Integer> graph = new Graph<>(directed, true);
+        for (int i = 0; i < n; i++) {
+            graph.addNode(i);
+        }
+        for (int i = 0; i < n; i++) {
+            if (i + 1 < n) {
+                graph.addEdge(i, i + 1, 1 + random.nextInt(MAX_EDGE_LENGTH));
+            }
+            for (int j = 1; j < GRAPH_DEGREE; j++) {
+                graph.addEdge(i, random.nextInt(n), 1 + random.nextInt(MAX_EDGE_LENGTH));
+            }
+        }
+        return graph;
+    }
+
+    /**
+     * Runs the benchmarks and prints the results.
+     *
+     * @param args optional number of elements, {@value #ELEMENTS} by default
+     */
+    public static void main(String[] args) {
+        int n = args.length > 0 ? Integer.parseInt(args[0]) : ELEMENTS;
+        double[] keys = new double[n];
+        Random random = new Random(42);
+        for (int i = 0; i < n; i++) {
+            keys[i] = random.nextDouble();
+        }
+        Comparator<Integer> comparator = (x, y) -> Double.compare(keys[x], keys[y]);
+
+        System.out.printf("PriorityQueue, %d elements, best of %d rounds (ns per element)%n", n, ROUNDS);
+        System.out.printf("%-8s %12s %12s%n", "arity", "push-heavy", "pop-heavy");
+        for (int arity : ARITIES) {
+            double push = measure(HeapBenchmark::pushHeavy, () -> new PriorityQueue<>(comparator, arity), n);
+            double pop = measure(HeapBenchmark::popHeavy, () -> new PriorityQueue<>(comparator, arity), n);
+            System.out.printf("%-8d %12.1f %12.1f%n", arity, push, pop);
+        }
+
+        // Radix heaps need integer keys that never go below the last one popped
+        System.out.printf("%nQueues, %d elements, best of %d rounds (ns per element)%n", n, ROUNDS);
+        System.out.printf("%-14s %12s%n", "queue", "pop-heavy");
+        System.out.printf("%-14s %12.1f%n", "binary heap",
+                          measure(HeapBenchmark::popHeavy, () -> new PriorityQueue<>(comparator), n));
+        System.out.printf("%-14s %12.1f%n", "swap heap",
+                          measure(HeapBenchmark::popHeavy, () -> new SwapPriorityQueue<>(comparator), n));
+        System.out.printf("%-14s %12.1f%n", "pairing heap",
+                          measure(HeapBenchmark::popHeavy, () -> new PairingHeap<>(comparator), n));
+        System.out.printf("%-14s %12.1f%n", "radix heap",
+                          measure(HeapBenchmark::popHeavy, () -> new RadixHeap<>(i -> (long) (keys[i] * Integer.MAX_VALUE)), n));
+
+        // Sifting with a hole writes each moved element to the map once, instead of twice per level
+        CountingKey[] elements = new CountingKey[n];
+        for (int i = 0; i < n; i++) {
+            elements[i] = new CountingKey(i);
+        }
+        Comparator<CountingKey> keyComparator = (x, y) -> Double.compare(keys[x.id], keys[y.id]);
+        System.out.printf("%nHash map accesses per element%n");
+        System.out.printf("%-14s %12s %12s%n", "queue", "push-heavy", "pop-heavy");
+        double[] hole = mapTraffic(() -> new PriorityQueue<>(keyComparator), elements);
+        double[] swap = mapTraffic(() -> new SwapPriorityQueue<>(keyComparator), elements);
+        System.out.printf("%-14s %12.1f %12.1f%n", "binary heap", hole[0], hole[1]);
+        System.out.printf("%-14s %12.1f %12.1f%n", "swap heap", swap[0], swap[1]);
+
+        int nodes = n / 10;
+        Graph<Integer, Integer> graph = randomGraph(nodes, true, random);
+        Function<ToDoubleFunction<Integer>, AbstractQueue<Integer>> binary = priority -> new PriorityQueue<>(Comparator.comparingDouble(priority));
+        Function<ToDoubleFunction<Integer>, AbstractQueue<Integer>> pairing = priority -> new PairingHeap<>(Comparator.comparingDouble(priority));
+        Function<ToDoubleFunction<Integer>, AbstractQueue<Integer>> radix = priority -> new RadixHeap<>(v -> (long) priority.applyAsDouble(v));
+
+        System.out.printf("%nGraph algorithms, %d nodes, %d edges, best of %d rounds (ms)%n", nodes, graph.numEdges(), ROUNDS);
+        System.out.printf("%-14s %12s %12s%n", "queue", "dijkstra", "prim");
+        System.out.printf("%-14s %12.1f %12.1f%n", "binary heap",
+                          measure(() -> (long) Dijkstra.shortestDistances(graph, 0, binary).size()) / 1e6,
+                          measure(() -> (long) Prim.minimumSpanningForest(graph, binary).size()) / 1e6);
+        System.out.printf("%-14s %12.1f %12.1f%n", "pairing heap",
+                          measure(() -> (long) Dijkstra.shortestDistances(graph, 0, pairing).size()) / 1e6,
+                          measure(() -> (long) Prim.minimumSpanningForest(graph, pairing).size()) / 1e6);
+        System.out.printf("%-14s %12.1f %12s%n", "radix heap",
+                          measure(() -> (long) Dijkstra.shortestDistances(graph, 0, radix).size()) / 1e6, "-");
+    }
+}
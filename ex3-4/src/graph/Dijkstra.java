@@ -0,0 +1,89 @@
+package graph;
+
+import priorityqueue.AbstractQueue;
+import priorityqueue.PriorityQueue;
+import java.util.Comparator;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.Map;
+import java.util.Set;
+import java.util.function.Function;
+import java.util.function.ToDoubleFunction;
+
+/**
+ * Provides an implementation of Dijkstra's algorithm for the shortest paths from a node of a graph.
+ * <p>
+ * The queue holds the nodes reached but not yet settled, ordered by their tentative distance,
+ * and a node reached by a shorter path is moved up in place with
+ * {@link AbstractQueue#decreasePriority}, so the queue never grows past the number of nodes.
+ * Any {@link AbstractQueue} can be used, built from the function giving the priority of a node:
+ * a {@link priorityqueue.PairingHeap} makes decreasing a priority constant time, and since the
+ * distances popped never decrease, a {@link priorityqueue.RadixHeap} fits integer lengths.
+ */
+public class Dijkstra {
+
+    /**
+     * Computes the length of the shortest path from a source node to every node reachable from it.
+     *
+     * @param <V> the type of vertices in the graph
+     * @param <L> the type of the label of the edges, which must extend Number
+     * @param graph the graph whose edge labels are the lengths of the edges
+     * @param source the node the paths start from
+     * @return a map from each node reachable from the source to its distance from the source
+     * @throws IllegalArgumentException if the source is not in the graph, or an edge reached has a negative label
+     */
+    public static <V, L extends Number> Map<V, Double> shortestDistances(Graph<V, L> graph, V source) {
+        return shortestDistances(graph, source, priority -> new PriorityQueue<>(Comparator.comparingDouble(priority)));
+    }
+
+    /**
+     * Computes the length of the shortest path from a source node to every node reachable from it on a given kind of queue.
+     *
+     * @param <V> the type of vertices in the graph
+     * @param <L> the type of the label of the edges, which must extend Number
+     * @param graph the graph whose edge labels are the lengths of the edges
+     * @param source the node the paths start from
+     * @param queueFactory builds an empty queue ordering the nodes by the given priority, smallest first
+     * @return a map from each node reachable from the source to its distance from the source
+     * @throws IllegalArgumentException if the source is not in the graph, or an edge reached has a negative label
+     */
+    public static <V, L extends Number> Map<V, Double> shortestDistances(Graph<V, L> graph, V source, Function<ToDoubleFunction<V>, AbstractQueue<V>> queueFactory) {
+        if (!graph.containsNode(source)) {
+            throw new IllegalArgumentException("Source node is not in the graph.");
+        }
+        Map<V, Double> distances = new HashMap<>();
+        Set<V> settledNodes = new HashSet<>();
+        AbstractQueue<V> nodeQueue = queueFactory.apply(v -> distances.get(v));
+
+        distances.put(source, 0.0);
+        nodeQueue.push(source);
+
+        while (!nodeQueue.empty()) {
+            V node = nodeQueue.top();
+            nodeQueue.pop();
+            settledNodes.add(node);
+            double distance = distances.get(node);
+
+            for (AbstractEdge<V, L> edge : graph.getEdges(node)) {
+                double length = edge.getLabel().doubleValue();
+                if (length < 0) {
+                    throw new IllegalArgumentException("Edge labels cannot be negative.");
+                }
+                V end = edge.getEnd();
+                if (settledNodes.contains(end)) {
+                    continue;
+                }
+                Double current = distances.get(end);
+                if (current == null) {
+                    distances.put(end, distance + length);
+                    nodeQueue.push(end);
+                } else if (distance + length < current) {
+                    distances.put(end, distance + length);
+                    nodeQueue.decreasePriority(end);
+                }
+            }
+        }
+
+        return distances;
+    }
+}
@@ -199,6 +199,20 @@ public class Graph<V, L> implements AbstractGraph<V, L> {
         return edges;
     }
 
+    /**
+     * Returns the edges leaving a given node, in constant time.
+     *
+     * @param a the start node
+     * @return an unmodifiable view of the edges starting from the node, empty if the node does not exist
+     */
+    public Collection<Edge<V, L>> getEdges(V a) {
+        List<Edge<V, L>> edges = adjacencyList.get(a);
+        if (edges == null) {
+            return Collections.emptyList();
+        }
+        return Collections.unmodifiableList(edges);
+    }
+
     /**
      * Returns a collection of the neighbors of a given node.
      *
@@ -5,6 +5,11 @@ import org.junit.Before;
 import org.junit.Test;
 
 import java.util.*;
+import java.util.function.Function;
+import java.util.function.ToDoubleFunction;
+import priorityqueue.AbstractQueue;
+import priorityqueue.PairingHeap;
+import priorityqueue.RadixHeap;
 
 /**
  * Unit tests for the {@link Graph} class.
@@ -149,4 +154,86 @@ public class GraphTest {
         assertTrue(unlabelledGraph.containsEdge("B", "A")); // Undirected edge should be reciprocal
         assertNull(unlabelledGraph.getLabel("A", "B")); // No label should be associated with the edge
     }
+
+    /**
+     * Tests that Prim's algorithm spans every connected component with its lightest edges.
+     */
+    @Test
+    public void testMinimumSpanningForest() {
+        for (String node : new String[] {"A", "B", "C", "D", "E", "F"}) {
+            undirectedGraph.addNode(node);
+        }
+        undirectedGraph.addEdge("A", "B", 4);
+        undirectedGraph.addEdge("A", "C", 1);
+        undirectedGraph.addEdge("B", "C", 2);
+        undirectedGraph.addEdge("B", "D", 5);
+        undirectedGraph.addEdge("C", "D", 8);
+        undirectedGraph.addEdge("E", "F", 3);
+
+        Collection<? extends AbstractEdge<String, Integer>> forest = Prim.minimumSpanningForest(undirectedGraph);
+        int totalWeight = 0;
+        for (AbstractEdge<String, Integer> edge : forest) {
+            totalWeight += edge.getLabel();
+        }
+        assertEquals(4, forest.size()); // Six nodes in two components
+        assertEquals(11, totalWeight);
+    }
+
+    /**
+     * Tests the distances computed by Dijkstra's algorithm, where a shorter path is found after a longer one.
+     */
+    @Test
+    public void testShortestDistances() {
+        for (String node : new String[] {"A", "B", "C", "D", "E"}) {
+            directedGraph.addNode(node);
+        }
+        directedGraph.addEdge("A", "B", 10);
+        directedGraph.addEdge("A", "C", 3);
+        directedGraph.addEdge("C", "B", 4);
+        directedGraph.addEdge("B", "D", 2);
+        directedGraph.addEdge("C", "D", 8);
+        directedGraph.addEdge("D", "E", 1);
+        directedGraph.addEdge("E", "A", 1);
+
+        Map<String, Double> distances = Dijkstra.shortestDistances(directedGraph, "A");
+        assertEquals(0.0, distances.get("A"), 0.0);
+        assertEquals(7.0, distances.get("B"), 0.0);
+        assertEquals(3.0, distances.get("C"), 0.0);
+        assertEquals(9.0, distances.get("D"), 0.0);
+        assertEquals(10.0, distances.get("E"), 0.0);
+
+        distances = Dijkstra.shortestDistances(directedGraph, "E");
+        assertEquals(5, distances.size());
+        assertEquals(1.0, distances.get("A"), 0.0);
+    }
+
+    /**
+     * Tests that Prim's and Dijkstra's algorithms give the same results on the other queues.
+     */
+    @Test
+    public void testAlternativeQueues() {
+        for (int i = 0; i < 20; i++) {
+            undirectedGraph.addNode("N" + i);
+        }
+        for (int i = 0; i < 20; i++) {
+            undirectedGraph.addEdge("N" + i, "N" + ((i + 1) % 20), 1 + (i * 7) % 5);
+            undirectedGraph.addEdge("N" + i, "N" + ((i * 3) % 20), 2 + (i * 11) % 9);
+        }
+        Function<ToDoubleFunction<String>, AbstractQueue<String>> pairing = priority -> new PairingHeap<>(Comparator.comparingDouble(priority));
+        Function<ToDoubleFunction<String>, AbstractQueue<String>> radix = priority -> new RadixHeap<>(v -> (long) priority.applyAsDouble(v));
+
+        int expectedWeight = 0;
+        for (AbstractEdge<String, Integer> edge : Prim.minimumSpanningForest(undirectedGraph)) {
+            expectedWeight += edge.getLabel();
+        }
+        int weight = 0;
+        for (AbstractEdge<String, Integer> edge : Prim.minimumSpanningForest(undirectedGraph, pairing)) {
+            weight += edge.getLabel();
+        }
+        assertEquals(expectedWeight, weight);
+
+        Map<String, Double> expected = Dijkstra.shortestDistances(undirectedGraph, "N0");
+        assertEquals(expected, Dijkstra.shortestDistances(undirectedGraph, "N0", pairing));
+        assertEquals(expected, Dijkstra.shortestDistances(undirectedGraph, "N0", radix));
+    }
 }
@@ -1,39 +1,64 @@
 package graph;
 
+import priorityqueue.AbstractQueue;
 import priorityqueue.PriorityQueue;
 import java.util.Collection;
+import java.util.HashMap;
 import java.util.HashSet;
+import java.util.Map;
 import java.util.Set;
 import java.util.ArrayList;
 import java.util.Comparator;
 import java.util.List;
+import java.util.function.Function;
+import java.util.function.ToDoubleFunction;
 
 /**
  * Provides an implementation of Prim's algorithm for finding the Minimum Spanning Tree (MST) of a graph.
+ * <p>
+ * This is the eager version of the algorithm: the queue holds the nodes not yet in the tree, each
+ * ordered by the lightest edge reaching it from the tree, so it never grows past the number of
+ * nodes. When a lighter edge to a node is found, the node is moved up in place with
+ * {@link AbstractQueue#decreasePriority}. Any {@link AbstractQueue} can be used, built from the
+ * function giving the priority of a node; the keys popped are not monotone, so a
+ * {@link priorityqueue.RadixHeap} cannot.
  */
 public class Prim {
 
     /**
-     * Adds edges from a specified node to the priority queue if they connect to nodes not yet included in the MST.
+     * Offers the edges leaving a node newly included in the MST to the nodes they reach. A node
+     * reached for the first time is pushed into the queue; a node already in the queue moves up
+     * if the edge is lighter than the best one found so far.
      *
      * @param <V> the type of vertices in the graph
      * @param <L> the type of the label of the edges, which must extend Number
      * @param graph the graph from which edges are extracted
      * @param includedNodes the set of nodes already included in the MST
-     * @param edgeQueue the priority queue to which edges are added
-     * @param node the node whose edges are to be added
+     * @param bestEdges the lightest edge found so far to each node in the queue
+     * @param nodeQueue the priority queue of the nodes reached but not yet included
+     * @param node the node whose edges are to be offered
      */
-    private static <V, L extends Number> void addEdgesFromNode(Graph<V, L> graph, Set<V> includedNodes, PriorityQueue<AbstractEdge<V, L>> edgeQueue, V node) {
-        for (AbstractEdge<V, L> edge : graph.getEdges()) {
-            if (edge.getStart().equals(node) && !includedNodes.contains(edge.getEnd())) {
-                edgeQueue.push(edge);
+    private static <V, L extends Number> void relaxEdgesFromNode(Graph<V, L> graph, Set<V> includedNodes, Map<V, AbstractEdge<V, L>> bestEdges, AbstractQueue<V> nodeQueue, V node) {
+        for (AbstractEdge<V, L> edge : graph.getEdges(node)) {
+            V end = edge.getEnd();
+            if (includedNodes.contains(end)) {
+                continue;
+            }
+            AbstractEdge<V, L> best = bestEdges.get(end);
+            if (best == null) {
+                bestEdges.put(end, edge);
+                nodeQueue.push(end);
+            } else if (edge.getLabel().doubleValue() < best.getLabel().doubleValue()) {
+                bestEdges.put(end, edge);
+                nodeQueue.decreasePriority(end);
             }
         }
     }
 
     /**
      * Computes the Minimum Spanning Forest (MSF) of a graph using Prim's algorithm.
-     * The graph is assumed to be connected. If it is not connected, the result will be a forest (collection of MSTs).
+     * A tree is grown from every node not yet reached, so if the graph is not connected the
+     * result is a forest with one MST for each connected component.
      *
      * @param <V> the type of vertices in the graph
      * @param <L> the type of the label of the edges, which must extend Number
@@ -41,34 +66,42 @@ public class Prim {
      * @return a collection of edges that form the Minimum Spanning Forest
      */
     public static <V, L extends Number> Collection<? extends AbstractEdge<V, L>> minimumSpanningForest(Graph<V, L> graph) {
+        return minimumSpanningForest(graph, priority -> new PriorityQueue<>(Comparator.comparingDouble(priority)));
+    }
+
+    /**
+     * Computes the Minimum Spanning Forest (MSF) of a graph using Prim's algorithm on a given kind of queue.
+     *
+     * @param <V> the type of vertices in the graph
+     * @param <L> the type of the label of the edges, which must extend Number
+     * @param graph the graph from which the MSF is computed
+     * @param queueFactory builds an empty queue ordering the nodes by the given priority, smallest first
+     * @return a collection of edges that form the Minimum Spanning Forest
+     */
+    public static <V, L extends Number> Collection<? extends AbstractEdge<V, L>> minimumSpanningForest(Graph<V, L> graph, Function<ToDoubleFunction<V>, AbstractQueue<V>> queueFactory) {
         List<AbstractEdge<V, L>> mstEdges = new ArrayList<>();
         Set<V> includedNodes = new HashSet<>();
-        PriorityQueue<AbstractEdge<V, L>> edgeQueue = new PriorityQueue<>(Comparator.comparingDouble(e -> e.getLabel().doubleValue()));
-
-        // Start from an arbitrary node
-        V startNode = graph.getNodes().iterator().next();
-        includedNodes.add(startNode);
-        addEdgesFromNode(graph, includedNodes, edgeQueue, startNode);
+        Map<V, AbstractEdge<V, L>> bestEdges = new HashMap<>();
+        AbstractQueue<V> nodeQueue = queueFactory.apply(v -> bestEdges.get(v).getLabel().doubleValue());
 
-        // Process edges to form the MST
-        while (!edgeQueue.empty()) {
-            AbstractEdge<V, L> minEdge = edgeQueue.top();
-            edgeQueue.pop();
-
-            V start = minEdge.getStart();
-            V end = minEdge.getEnd();
-
-            // Skip edges that would form a cycle
-            if (includedNodes.contains(start) && includedNodes.contains(end)) {
+        for (V root : graph.getNodes()) {
+            if (includedNodes.contains(root)) {
                 continue;
             }
 
-            mstEdges.add(minEdge);
+            // Start a new tree from the first node of a component not reached yet
+            includedNodes.add(root);
+            relaxEdgesFromNode(graph, includedNodes, bestEdges, nodeQueue, root);
 
-            // Add the newly included node and its edges to the priority queue
-            V newNode = includedNodes.contains(start) ? end : start;
-            includedNodes.add(newNode);
-            addEdgesFromNode(graph, includedNodes, edgeQueue, newNode);
+            // Include the node reached by the lightest edge until the component is spanned
+            while (!nodeQueue.empty()) {
+                V node = nodeQueue.top();
+                nodeQueue.pop();
+
+                mstEdges.add(bestEdges.remove(node));
+                includedNodes.add(node);
+                relaxEdgesFromNode(graph, includedNodes, bestEdges, nodeQueue, node);
+            }
         }
 
         return mstEdges;
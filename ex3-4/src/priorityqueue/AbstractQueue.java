@@ -52,4 +52,25 @@ public interface AbstractQueue<E> {
      * @return {@code true} if the element was removed successfully, {@code false} otherwise
      */
     boolean remove(E e); // O(logN)
+
+    /**
+     * Restores the order of the queue after the priority of an element in it has changed.
+     * The priority may have moved in either direction; a decrease is the usual case, as in
+     * the eager versions of Prim's and Dijkstra's algorithms.
+     *
+     * @param e the element whose priority has changed
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    boolean updatePriority(E e); // O(logN)
+
+    /**
+     * Restores the order of the queue after the priority of an element in it has decreased.
+     * Queues that can move an element in one direction only more cheaply override this.
+     *
+     * @param e the element whose priority has decreased
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    default boolean decreasePriority(E e) { // O(logN)
+        return updatePriority(e);
+    }
 }
@@ -0,0 +1,322 @@
+package priorityqueue;
+
+import java.util.ArrayList;
+import java.util.Comparator;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ThreadLocalRandom;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicReferenceArray;
+import java.util.concurrent.locks.ReentrantLock;
+import java.util.function.Predicate;
+
+/**
+ * A thread-safe, relaxed priority queue: a MultiQueue of sequential heaps.
+ * <p>
+ * The queue is made of {@code m = c * p} binary heaps, {@code c} for each of the {@code p}
+ * threads expected to use it, each behind its own lock. A push goes to a random heap; a pop
+ * looks at the tops of two random heaps, without locking them, and takes the better one. When
+ * a lock is held by another thread, the operation draws other heaps instead of waiting, so
+ * threads rarely contend and throughput grows almost linearly with the number of threads.
+ * <p>
+ * The price is that a pop does not always return the smallest element. Its rank error, the
+ * number of smaller elements left in the queue, is {@code O(m)} in expectation and
+ * {@code O(m log m)} with high probability, independently of the size of the queue. Algorithms
+ * that can absorb it, such as label-correcting shortest paths or Boruvka-style forests that
+ * tolerate out-of-order relaxations, can then run on several threads.
+ * <p>
+ * The comparator may be called concurrently on elements of different heaps, so the priorities
+ * it reads must be safe to read from several threads. The heap holding each element is kept in
+ * a concurrent map, which gives {@code contains} in constant time and lets {@code remove} and
+ * {@code updatePriority} lock only that heap.
+ *
+ * @param <E> the type of elements in the queue
+ */
+public class ConcurrentRelaxedPriorityQueue<E> implements AbstractQueue<E> {
+    /**
+     * The number of heaps for each thread used when none is given.
+     */
+    public static final int DEFAULT_QUEUES_PER_THREAD = 2;
+
+    private final ArrayList<PriorityQueue<E>> heaps;
+    private final ReentrantLock[] locks;
+    private final AtomicReferenceArray<E> tops;          // Top of each heap, null if it is empty
+    private final ConcurrentHashMap<E, Integer> owners;  // Heap holding each element
+    private final AtomicInteger size;
+    private final Comparator<E> comparator;
+
+    /**
+     * Constructs a new {@code ConcurrentRelaxedPriorityQueue} for a number of threads, with
+     * {@value #DEFAULT_QUEUES_PER_THREAD} heaps for each.
+     *
+     * @param comparator the comparator to determine the order of elements in the queue
+     * @param threads the number of threads expected to use the queue
+     * @throws IllegalArgumentException if {@code threads} is not positive
+     */
+    public ConcurrentRelaxedPriorityQueue(Comparator<E> comparator, int threads) {
+        this(comparator, threads, DEFAULT_QUEUES_PER_THREAD);
+    }
+
+    /**
+     * Constructs a new {@code ConcurrentRelaxedPriorityQueue} for a number of threads.
+     *
+     * @param comparator the comparator to determine the order of elements in the queue
+     * @param threads the number of threads expected to use the queue
+     * @param queuesPerThread the number of heaps for each thread
+     * @throws IllegalArgumentException if {@code threads} or {@code queuesPerThread} is not positive
+     * @throws IllegalStateException if the comparator is {@code null}
+     */
+    public ConcurrentRelaxedPriorityQueue(Comparator<E> comparator, int threads, int queuesPerThread) {
+        if (threads < 1 || queuesPerThread < 1) {
+            throw new IllegalArgumentException("Threads and queues per thread must be positive.");
+        }
+        if (comparator == null) {
+            throw new IllegalStateException("Comparator cannot be null.");
+        }
+        int count = threads * queuesPerThread;
+        this.heaps = new ArrayList<>(count);
+        this.locks = new ReentrantLock[count];
+        for (int i = 0; i < count; i++) {
+            heaps.add(new PriorityQueue<>(comparator));
+            locks[i] = new ReentrantLock();
+        }
+        this.tops = new AtomicReferenceArray<>(count);
+        this.owners = new ConcurrentHashMap<>();
+        this.size = new AtomicInteger();
+        this.comparator = comparator;
+    }
+
+    /**
+     * Returns the number of heaps the queue is made of.
+     *
+     * @return the number of heaps
+     */
+    public int getQueueCount() {
+        return locks.length;
+    }
+
+    /**
+     * Checks if the queue is empty.
+     *
+     * @return {@code true} if the queue is empty, {@code false} otherwise
+     */
+    @Override
+    public boolean empty() {
+        return size.get() == 0;
+    }
+
+    /**
+     * Returns the number of elements in the queue.
+     *
+     * @return the size of the queue
+     */
+    public int size() {
+        return size.get();
+    }
+
+    /**
+     * Adds an element to a random heap. If the element is already in the queue, it is not added again.
+     *
+     * @param e the element to be added
+     * @return {@code true} if the element was added successfully, {@code false} otherwise
+     */
+    @Override
+    public boolean push(E e) {
+        ThreadLocalRandom random = ThreadLocalRandom.current();
+        while (true) {
+            int i = random.nextInt(locks.length);
+            if (!locks[i].tryLock()) {
+                continue; // Another thread holds it, try another heap
+            }
+            try {
+                if (owners.putIfAbsent(e, i) != null) {
+                    return false;
+                }
+                heaps.get(i).push(e);
+                size.incrementAndGet();
+                refreshTop(i);
+                return true;
+            } finally {
+                locks[i].unlock();
+            }
+        }
+    }
+
+    /**
+     * Checks if the queue contains a specific element.
+     *
+     * @param e the element to check
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    @Override
+    public boolean contains(E e) {
+        return owners.containsKey(e);
+    }
+
+    /**
+     * Retrieves the smallest of the tops of the heaps without removing it. With other threads
+     * at work, the element may be gone or no longer the smallest by the time it is returned.
+     *
+     * @return the element at the top of the queue
+     * @throws IllegalStateException if the queue is empty
+     */
+    @Override
+    public E top() {
+        E best = null;
+        for (int i = 0; i < locks.length; i++) {
+            E top = tops.get(i);
+            if (top != null && (best == null || comparator.compare(top, best) < 0)) {
+                best = top;
+            }
+        }
+        if (best == null) {
+            throw new IllegalStateException("Queue is empty.");
+        }
+        return best;
+    }
+
+    /**
+     * Removes an element close to the top of the queue, as {@link #poll()} does.
+     * Since another thread may take the element returned by {@link #top()} first, threads
+     * sharing the queue should call {@link #poll()} instead of {@code top} and {@code pop}.
+     *
+     * @throws IllegalStateException if the queue is empty
+     */
+    @Override
+    public void pop() {
+        if (poll() == null) {
+            throw new IllegalStateException("Queue is empty.");
+        }
+    }
+
+    /**
+     * Removes and returns an element close to the top of the queue: the top of the better of two
+     * random heaps, within the rank error bound given in the class description.
+     *
+     * @return the element removed, or {@code null} if the queue is empty
+     */
+    public E poll() {
+        ThreadLocalRandom random = ThreadLocalRandom.current();
+        while (size.get() > 0) {
+            int i = random.nextInt(locks.length);
+            int j = random.nextInt(locks.length);
+            E first = tops.get(i);
+            E second = tops.get(j);
+            if (first == null && second == null) {
+                i = firstNonEmpty();
+                if (i < 0) {
+                    continue; // The last elements are being pushed or popped
+                }
+            } else if (first == null || (second != null && comparator.compare(second, first) < 0)) {
+                i = j;
+            }
+            if (!locks[i].tryLock()) {
+                continue;
+            }
+            try {
+                PriorityQueue<E> heap = heaps.get(i);
+                if (heap.empty()) {
+                    continue;
+                }
+                E e = heap.top();
+                heap.pop();
+                owners.remove(e);
+                size.decrementAndGet();
+                refreshTop(i);
+                return e;
+            } finally {
+                locks[i].unlock();
+            }
+        }
+        return null;
+    }
+
+    /**
+     * Removes a specific element from the queue if it is present.
+     *
+     * @param e the element to be removed
+     * @return {@code true} if the element was removed successfully, {@code false} otherwise
+     */
+    @Override
+    public boolean remove(E e) {
+        return onOwner(e, heap -> {
+            heap.remove(e);
+            owners.remove(e);
+            size.decrementAndGet();
+            return true;
+        });
+    }
+
+    /**
+     * Restores the order of the heap holding an element after its priority has changed.
+     *
+     * @param e the element whose priority has changed
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    @Override
+    public boolean updatePriority(E e) {
+        return onOwner(e, heap -> heap.updatePriority(e));
+    }
+
+    /**
+     * Restores the order of the heap holding an element after its priority has decreased.
+     *
+     * @param e the element whose priority has decreased
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    @Override
+    public boolean decreasePriority(E e) {
+        return onOwner(e, heap -> heap.decreasePriority(e));
+    }
+
+    /**
+     * Runs an operation on the heap holding an element, with that heap locked. Unlike push and
+     * pop, this has to wait for the lock, since no other heap will do.
+     *
+     * @param e the element
+     * @param operation the operation to be run on the heap
+     * @return the result of the operation, or {@code false} if the element is not in the queue
+     */
+    private boolean onOwner(E e, Predicate<PriorityQueue<E>> operation) {
+        while (true) {
+            Integer i = owners.get(e);
+            if (i == null) {
+                return false;
+            }
+            locks[i].lock();
+            try {
+                if (!i.equals(owners.get(e))) {
+                    continue; // Popped, and maybe pushed again elsewhere, in the meantime
+                }
+                boolean result = operation.test(heaps.get(i));
+                refreshTop(i);
+                return result;
+            } finally {
+                locks[i].unlock();
+            }
+        }
+    }
+
+    /**
+     * Publishes the top of a heap after it has changed. Must be called with the heap locked.
+     *
+     * @param i the index of the heap
+     */
+    private void refreshTop(int i) {
+        PriorityQueue<E> heap = heaps.get(i);
+        tops.set(i, heap.empty() ? null : heap.top());
+    }
+
+    /**
+     * Finds a heap that looks non-empty, scanning the published tops.
+     *
+     * @return the index of the heap, or -1 if all of them look empty
+     */
+    private int firstNonEmpty() {
+        for (int i = 0; i < locks.length; i++) {
+            if (tops.get(i) != null) {
+                return i;
+            }
+        }
+        return -1;
+    }
+}
@@ -0,0 +1,251 @@
+package priorityqueue;
+
+import java.util.Arrays;
+
+/**
+ * A priority queue of {@code int} element ids with {@code double} keys, using a binary heap.
+ * <p>
+ * The ids range over [0, capacity), so nothing needs to be boxed or hashed: the heap is an
+ * {@code int[]} of ids, the keys live in a {@code double[]} indexed by id, and the position of
+ * each id in the heap is kept in an {@code int[]}, with -1 for the ids not in the queue. The
+ * operations follow {@link AbstractQueue}: an id already in the queue is not pushed again, and
+ * {@code top} and {@code pop} throw on an empty queue.
+ */
+public class IndexedDoublePriorityQueue {
+    private final int[] heap;
+    private final int[] position;
+    private final double[] keys;
+    private int size;
+
+    /**
+     * Constructs an empty {@code IndexedDoublePriorityQueue} for the ids in [0, capacity).
+     *
+     * @param capacity the number of ids
+     * @throws IllegalArgumentException if {@code capacity} is negative
+     */
+    public IndexedDoublePriorityQueue(int capacity) {
+        if (capacity < 0) {
+            throw new IllegalArgumentException("Capacity cannot be negative.");
+        }
+        this.heap = new int[capacity];
+        this.position = new int[capacity];
+        this.keys = new double[capacity];
+        this.size = 0;
+        Arrays.fill(position, -1);
+    }
+
+    /**
+     * Returns the number of ids the queue can hold.
+     *
+     * @return the capacity of the queue
+     */
+    public int capacity() {
+        return heap.length;
+    }
+
+    /**
+     * Returns the number of ids in the queue.
+     *
+     * @return the size of the queue
+     */
+    public int size() {
+        return size;
+    }
+
+    /**
+     * Checks if the queue is empty.
+     *
+     * @return {@code true} if the queue is empty, {@code false} otherwise
+     */
+    public boolean empty() {
+        return size == 0;
+    }
+
+    /**
+     * Adds an id to the queue with a key. If the id is already in the queue, it is not added again.
+     *
+     * @param id the id to be added
+     * @param key the key of the id
+     * @return {@code true} if the id was added successfully, {@code false} otherwise
+     * @throws IllegalArgumentException if the id is out of range or the key is NaN
+     */
+    public boolean push(int id, double key) {
+        checkId(id);
+        if (Double.isNaN(key)) {
+            throw new IllegalArgumentException("Key cannot be NaN.");
+        }
+        if (position[id] >= 0) {
+            return false;
+        }
+        keys[id] = key;
+        siftUp(size++, id);
+        return true;
+    }
+
+    /**
+     * Checks if the queue contains an id, in constant time.
+     *
+     * @param id the id to check
+     * @return {@code true} if the id is in the queue, {@code false} otherwise
+     */
+    public boolean contains(int id) {
+        return id >= 0 && id < position.length && position[id] >= 0;
+    }
+
+    /**
+     * Retrieves the id with the smallest key without removing it.
+     *
+     * @return the id at the top of the queue
+     * @throws IllegalStateException if the queue is empty
+     */
+    public int top() {
+        if (empty()) {
+            throw new IllegalStateException("Queue is empty.");
+        }
+        return heap[0];
+    }
+
+    /**
+     * Retrieves the smallest key in the queue.
+     *
+     * @return the key of the id at the top of the queue
+     * @throws IllegalStateException if the queue is empty
+     */
+    public double topKey() {
+        return keys[top()];
+    }
+
+    /**
+     * Returns the key of an id in the queue.
+     *
+     * @param id the id
+     * @return the key of the id
+     * @throws IllegalArgumentException if the id is not in the queue
+     */
+    public double getKey(int id) {
+        if (!contains(id)) {
+            throw new IllegalArgumentException("Id " + id + " is not in the queue.");
+        }
+        return keys[id];
+    }
+
+    /**
+     * Removes the id at the top of the queue.
+     *
+     * @throws IllegalStateException if the queue is empty
+     */
+    public void pop() {
+        remove(top());
+    }
+
+    /**
+     * Removes a specific id from the queue if it is present.
+     *
+     * @param id the id to be removed
+     * @return {@code true} if the id was removed successfully, {@code false} otherwise
+     */
+    public boolean remove(int id) {
+        if (!contains(id)) {
+            return false;
+        }
+        int index = position[id];
+        position[id] = -1;
+        int last = heap[--size];
+        if (index < size) {
+            // The last id fills the hole, moving up or down from there
+            if (index > 0 && keys[last] < keys[heap[(index - 1) / 2]]) {
+                siftUp(index, last);
+            } else {
+                siftDown(index, last);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Changes the key of an id in the queue and restores the heap order from its position.
+     *
+     * @param id the id whose key changes
+     * @param key the new key
+     * @return {@code true} if the id was in the queue, {@code false} otherwise
+     * @throws IllegalArgumentException if the key is NaN
+     */
+    public boolean updateKey(int id, double key) {
+        if (Double.isNaN(key)) {
+            throw new IllegalArgumentException("Key cannot be NaN.");
+        }
+        if (!contains(id)) {
+            return false;
+        }
+        double old = keys[id];
+        keys[id] = key;
+        if (key < old) {
+            siftUp(position[id], id);
+        } else {
+            siftDown(position[id], id);
+        }
+        return true;
+    }
+
+    /**
+     * Moves an id up from a hole at {@code index} until its parent has a key not larger than its own.
+     * Each parent moved down into the hole is written, with its position, exactly once.
+     *
+     * @param index the position of the hole
+     * @param id the id to be placed
+     */
+    private void siftUp(int index, int id) {
+        double key = keys[id];
+        while (index > 0) {
+            int parent = (index - 1) / 2;
+            int parentId = heap[parent];
+            if (keys[parentId] <= key) {
+                break;
+            }
+            heap[index] = parentId;
+            position[parentId] = index;
+            index = parent;
+        }
+        heap[index] = id;
+        position[id] = index;
+    }
+
+    /**
+     * Moves an id down from a hole at {@code index} until no child has a smaller key.
+     *
+     * @param index the position of the hole
+     * @param id the id to be placed
+     */
+    private void siftDown(int index, int id) {
+        double key = keys[id];
+        int half = size / 2; // Positions from here on have no children
+        while (index < half) {
+            int child = 2 * index + 1;
+            int childId = heap[child];
+            if (child + 1 < size && keys[heap[child + 1]] < keys[childId]) {
+                child++;
+                childId = heap[child];
+            }
+            if (key <= keys[childId]) {
+                break;
+            }
+            heap[index] = childId;
+            position[childId] = index;
+            index = child;
+        }
+        heap[index] = id;
+        position[id] = index;
+    }
+
+    /**
+     * Checks that an id is in range.
+     *
+     * @param id the id to check
+     * @throws IllegalArgumentException if the id is out of range
+     */
+    private void checkId(int id) {
+        if (id < 0 || id >= position.length) {
+            throw new IllegalArgumentException("Id " + id + " is out of range [0, " + position.length + ").");
+        }
+    }
+}
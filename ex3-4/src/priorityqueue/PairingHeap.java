@@ -0,0 +1,340 @@
+package priorityqueue;
+
+import java.util.Comparator;
+import java.util.HashMap;
+
+/**
+ * A priority queue implementation using a pairing heap.
+ * <p>
+ * The heap is a tree in which every node is not smaller than its parent, stored as a list of
+ * children per node. Two trees are linked by making the root with the larger element the first
+ * child of the other one, and popping merges the children of the root in pairs, left to right,
+ * and then the pairs right to left. Pushing and decreasing a priority cost {@code O(1)}, which
+ * suits algorithms such as Dijkstra's that decrease priorities more often than they pop;
+ * popping and removing cost {@code O(logN)} amortized.
+ * <p>
+ * Each element is held by a {@link Handle}, found from the element through a hash map; callers
+ * that keep the handles can decrease priorities with {@link #decreaseKey(Handle)} without
+ * looking them up.
+ *
+ * @param <E> the type of elements in the queue
+ */
+public class PairingHeap<E> implements AbstractQueue<E> {
+
+    /**
+     * A node of the heap, holding one element.
+     *
+     * @param <E> the type of the element
+     */
+    public static final class Handle<E> {
+        private final E element;
+        private Handle<E> child;    // First child
+        private Handle<E> sibling;  // Next sibling
+        private Handle<E> previous; // Previous sibling, or the parent for a first child
+
+        private Handle(E element) {
+            this.element = element;
+        }
+
+        /**
+         * Returns the element held by this handle.
+         *
+         * @return the element
+         */
+        public E getElement() {
+            return element;
+        }
+    }
+
+    private Handle<E> root;
+    private HashMap<E, Handle<E>> handles;
+    private Comparator<E> comparator;
+
+    /**
+     * Constructs a new {@code PairingHeap} with the specified comparator.
+     *
+     * @param comparator the comparator to determine the order of elements in the queue
+     */
+    public PairingHeap(Comparator<E> comparator) {
+        this.root = null;
+        this.handles = new HashMap<>();
+        this.comparator = comparator;
+    }
+
+    /**
+     * Checks if the queue is empty.
+     *
+     * @return {@code true} if the queue is empty, {@code false} otherwise
+     */
+    @Override
+    public boolean empty() {
+        return root == null;
+    }
+
+    /**
+     * Returns the number of elements in the queue.
+     *
+     * @return the size of the queue
+     */
+    public int size() {
+        return handles.size();
+    }
+
+    /**
+     * Adds an element to the queue. If the element is already in the queue, it is not added again.
+     *
+     * @param e the element to be added
+     * @return {@code true} if the element was added successfully, {@code false} otherwise
+     */
+    @Override
+    public boolean push(E e) {
+        if (contains(e)) {
+            return false;
+        }
+        Handle<E> handle = new Handle<>(e);
+        handles.put(e, handle);
+        root = meld(root, handle);
+        return true;
+    }
+
+    /**
+     * Checks if the queue contains a specific element.
+     *
+     * @param e the element to check
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    @Override
+    public boolean contains(E e) {
+        return handles.containsKey(e);
+    }
+
+    /**
+     * Returns the handle holding an element of the queue.
+     *
+     * @param e the element
+     * @return the handle of the element, or {@code null} if it is not in the queue
+     */
+    public Handle<E> handle(E e) {
+        return handles.get(e);
+    }
+
+    /**
+     * Retrieves the element at the top of the queue without removing it.
+     *
+     * @return the element at the top of the queue
+     * @throws IllegalStateException if the queue is empty
+     */
+    @Override
+    public E top() {
+        if (empty()) {
+            throw new IllegalStateException("Queue is empty.");
+        }
+        return root.element;
+    }
+
+    /**
+     * Removes the element at the top of the queue.
+     *
+     * @throws IllegalStateException if the queue is empty
+     */
+    @Override
+    public void pop() {
+        if (empty()) {
+            throw new IllegalStateException("Queue is empty.");
+        }
+        handles.remove(root.element);
+        Handle<E> children = root.child;
+        root.child = null;
+        root = mergePairs(children);
+    }
+
+    /**
+     * Removes a specific element from the queue if it is present.
+     *
+     * @param e the element to be removed
+     * @return {@code true} if the element was removed successfully, {@code false} otherwise
+     */
+    @Override
+    public boolean remove(E e) {
+        Handle<E> handle = handles.remove(e);
+        if (handle == null) {
+            return false;
+        }
+        if (handle == root) {
+            root = null;
+        } else {
+            cut(handle);
+        }
+        Handle<E> children = handle.child;
+        handle.child = null;
+        root = meld(root, mergePairs(children));
+        return true;
+    }
+
+    /**
+     * Restores the order of the queue after the priority of an element in it has changed.
+     * Since the element may now be larger than its children, they are merged back into the
+     * heap apart from it.
+     *
+     * @param e the element whose priority has changed
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    @Override
+    public boolean updatePriority(E e) {
+        Handle<E> handle = handles.get(e);
+        if (handle == null) {
+            return false;
+        }
+        if (handle == root) {
+            root = null;
+        } else {
+            cut(handle);
+        }
+        Handle<E> children = handle.child;
+        handle.child = null;
+        root = meld(meld(root, mergePairs(children)), handle);
+        return true;
+    }
+
+    /**
+     * Restores the order of the queue after the priority of an element in it has decreased.
+     *
+     * @param e the element whose priority has decreased
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    @Override
+    public boolean decreasePriority(E e) {
+        Handle<E> handle = handles.get(e);
+        if (handle == null) {
+            return false;
+        }
+        decreaseKey(handle);
+        return true;
+    }
+
+    /**
+     * Restores the order of the queue after the priority of the element held by a handle has
+     * decreased, in constant time: the element is still not larger than its children, so its
+     * subtree is cut from its parent and linked with the root.
+     *
+     * @param handle the handle of the element whose priority has decreased
+     * @throws IllegalArgumentException if the handle does not belong to this queue
+     */
+    public void decreaseKey(Handle<E> handle) {
+        if (handles.get(handle.element) != handle) {
+            throw new IllegalArgumentException("Handle does not belong to this queue.");
+        }
+        if (handle != root) {
+            cut(handle);
+            root = link(root, handle);
+        }
+    }
+
+    /**
+     * Detaches a node that is not the root, with its subtree, from its parent.
+     *
+     * @param handle the node to be detached
+     */
+    private void cut(Handle<E> handle) {
+        if (handle.previous.child == handle) {
+            handle.previous.child = handle.sibling;
+        } else {
+            handle.previous.sibling = handle.sibling;
+        }
+        if (handle.sibling != null) {
+            handle.sibling.previous = handle.previous;
+        }
+        handle.previous = null;
+        handle.sibling = null;
+    }
+
+    /**
+     * Links two trees, either of which may be empty.
+     *
+     * @param a the root of the first tree, or {@code null}
+     * @param b the root of the second tree, or {@code null}
+     * @return the root of the linked tree
+     */
+    private Handle<E> meld(Handle<E> a, Handle<E> b) {
+        if (a == null) {
+            return b;
+        }
+        if (b == null) {
+            return a;
+        }
+        return link(a, b);
+    }
+
+    /**
+     * Links two non-empty trees, making the root with the larger element the first child of the other.
+     *
+     * @param a the root of the first tree
+     * @param b the root of the second tree
+     * @return the root of the linked tree
+     */
+    private Handle<E> link(Handle<E> a, Handle<E> b) {
+        if (compare(b.element, a.element) < 0) {
+            Handle<E> temp = a;
+            a = b;
+            b = temp;
+        }
+        b.previous = a;
+        b.sibling = a.child;
+        if (a.child != null) {
+            a.child.previous = b;
+        }
+        a.child = b;
+        return a;
+    }
+
+    /**
+     * Merges a list of sibling trees in two passes: in pairs from left to right, then the
+     * pairs from right to left. Both passes are iterative, so long lists cannot overflow the stack.
+     *
+     * @param first the first tree of the list, or {@code null}
+     * @return the root of the merged tree, or {@code null} if the list is empty
+     */
+    private Handle<E> mergePairs(Handle<E> first) {
+        Handle<E> pairs = null; // Merged pairs, the last one first, chained through their siblings
+        while (first != null) {
+            Handle<E> a = first;
+            Handle<E> b = a.sibling;
+            first = b == null ? null : b.sibling;
+            a.previous = null;
+            a.sibling = null;
+            if (b != null) {
+                b.previous = null;
+                b.sibling = null;
+                a = link(a, b);
+            }
+            a.sibling = pairs;
+            pairs = a;
+        }
+
+        Handle<E> merged = null;
+        while (pairs != null) {
+            Handle<E> next = pairs.sibling;
+            pairs.sibling = null;
+            merged = meld(merged, pairs);
+            pairs = next;
+        }
+        return merged;
+    }
+
+    /**
+     * Compares two elements using the specified comparator.
+     *
+     * @param e1 the first element to be compared
+     * @param e2 the second element to be compared
+     * @return a negative integer, zero, or a positive integer as the first element
+     *         is less than, equal to, or greater than the second element
+     * @throws IllegalStateException if the comparator is {@code null}
+     */
+    private int compare(E e1, E e2) {
+        if (comparator != null) {
+            return comparator.compare(e1, e2);
+        } else {
+            throw new IllegalStateException("Comparator cannot be null.");
+        }
+    }
+}
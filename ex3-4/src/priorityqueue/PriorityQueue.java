@@ -1,30 +1,92 @@
 package priorityqueue;
 
 import java.util.ArrayList;
+import java.util.Collection;
+import java.util.Collections;
 import java.util.Comparator;
 import java.util.HashMap;
 import java.util.List;
 import java.util.Map;
 
 /**
- * A priority queue implementation using a binary heap.
+ * A priority queue implementation using a d-ary heap, binary by default.
+ * <p>
+ * The children of the element at index {@code i} are at indices {@code d * i + 1} to
+ * {@code d * i + d}, next to each other. A larger arity makes the heap shallower, so pushes
+ * sift up through fewer levels, at the cost of comparing {@code d} children per level when
+ * sifting down.
  *
  * @param <E> the type of elements in the queue
  */
 public class PriorityQueue<E> implements AbstractQueue<E> {
+    /**
+     * The arity used when none is given.
+     */
+    public static final int DEFAULT_ARITY = 2;
+
     private ArrayList<E> queue;
     private HashMap<E, Integer> hashMap;
     private Comparator<E> comparator;
+    private final int arity;
 
     /**
-     * Constructs a new {@code PriorityQueue} with the specified comparator.
+     * Constructs a new binary {@code PriorityQueue} with the specified comparator.
      *
      * @param comparator the comparator to determine the order of elements in the queue
      */
     public PriorityQueue(Comparator<E> comparator) {
+        this(comparator, DEFAULT_ARITY);
+    }
+
+    /**
+     * Constructs a new {@code PriorityQueue} with the specified comparator and heap arity.
+     *
+     * @param comparator the comparator to determine the order of elements in the queue
+     * @param arity the number of children of each node of the heap
+     * @throws IllegalArgumentException if {@code arity} is less than 2
+     */
+    public PriorityQueue(Comparator<E> comparator, int arity) {
+        if (arity < 2) {
+            throw new IllegalArgumentException("Arity must be at least 2.");
+        }
         this.queue = new ArrayList<>();
         this.hashMap = new HashMap<>();
         this.comparator = comparator;
+        this.arity = arity;
+    }
+
+    /**
+     * Constructs a new binary {@code PriorityQueue} holding the specified elements.
+     *
+     * @param elements the elements to be added; duplicates are added once
+     * @param comparator the comparator to determine the order of elements in the queue
+     * @see #pushAll(Collection)
+     */
+    public PriorityQueue(Collection<? extends E> elements, Comparator<E> comparator) {
+        this(elements, comparator, DEFAULT_ARITY);
+    }
+
+    /**
+     * Constructs a new {@code PriorityQueue} with the specified heap arity, holding the specified elements.
+     *
+     * @param elements the elements to be added; duplicates are added once
+     * @param comparator the comparator to determine the order of elements in the queue
+     * @param arity the number of children of each node of the heap
+     * @throws IllegalArgumentException if {@code arity} is less than 2
+     * @see #pushAll(Collection)
+     */
+    public PriorityQueue(Collection<? extends E> elements, Comparator<E> comparator, int arity) {
+        this(comparator, arity);
+        pushAll(elements);
+    }
+
+    /**
+     * Returns the number of children of each node of the heap.
+     *
+     * @return the arity of the heap
+     */
+    public int getArity() {
+        return arity;
     }
 
     /**
@@ -37,6 +99,15 @@ public class PriorityQueue<E> implements AbstractQueue<E> {
         return queue.isEmpty();
     }
 
+    /**
+     * Returns the number of elements in the queue.
+     *
+     * @return the size of the queue
+     */
+    public int size() {
+        return queue.size();
+    }
+
     /**
      * Adds an element to the queue. If the element is already in the queue, it is not added again.
      *
@@ -48,14 +119,115 @@ public class PriorityQueue<E> implements AbstractQueue<E> {
         if (contains(e)) {
             return false;
         } else {
-            queue.add(e);
-            int index = queue.size() - 1;
-            hashMap.put(e, index);
-            fixQueue(index);
+            queue.add(e); // Opens a hole at the end
+            siftUp(queue.size() - 1, e);
             return true;
         }
     }
 
+    /**
+     * Adds a collection of elements to the queue. Elements already in the queue, or repeated in
+     * the collection, are added once.
+     * <p>
+     * The elements are appended to the heap first. When they are at least as many as those
+     * already there, the heap is then rebuilt bottom-up with Floyd's method, sifting down every
+     * node that has children from the last one to the root, in {@code O(N)} time; otherwise
+     * each one is sifted up. The array and, if the queue is empty, the hash map are sized for
+     * all the elements up front, so neither grows while they are added.
+     *
+     * @param elements the elements to be added
+     * @return {@code true} if at least one element was added, {@code false} otherwise
+     */
+    public boolean pushAll(Collection<? extends E> elements) {
+        int oldSize = queue.size();
+        queue.ensureCapacity(oldSize + elements.size());
+        if (hashMap.isEmpty()) {
+            hashMap = new HashMap<>((int) ((oldSize + elements.size()) / 0.75f) + 1);
+        }
+        for (E e : elements) {
+            if (hashMap.putIfAbsent(e, queue.size()) == null) {
+                queue.add(e);
+            }
+        }
+
+        int size = queue.size();
+        if (size - oldSize >= oldSize) {
+            heapify();
+        } else {
+            for (int index = oldSize; index < size; index++) {
+                siftUp(index, queue.get(index));
+            }
+        }
+        return size > oldSize;
+    }
+
+    /**
+     * Removes the {@code k} smallest elements of the queue and returns them in order.
+     * <p>
+     * When popping them one by one would cost more than rebuilding the heap, that is when
+     * {@code k} times the depth of the heap is at least its size, the elements are instead
+     * picked from the heap without changing it, growing a frontier of candidate positions
+     * from the root in a small heap of their own, in {@code O(k log k)} time. The remaining
+     * elements are then compacted and heapified in {@code O(N)} time, so each pays one
+     * write to the hash map instead of one per level of each pop.
+     *
+     * @param k the number of elements to be removed
+     * @return the removed elements, smallest first; all of them if the queue holds fewer than {@code k}
+     * @throws IllegalArgumentException if {@code k} is negative
+     */
+    public List<E> popK(int k) {
+        if (k < 0) {
+            throw new IllegalArgumentException("k cannot be negative.");
+        }
+        int size = queue.size();
+        k = Math.min(k, size);
+        List<E> popped = new ArrayList<>(k);
+
+        int depth = 0;
+        for (long level = 1; level <= size; level = level * arity + 1) {
+            depth++;
+        }
+        if ((long) k * depth < size) {
+            for (int i = 0; i < k; i++) {
+                popped.add(top());
+                pop();
+            }
+            return popped;
+        }
+
+        boolean[] taken = new boolean[size];
+        PriorityQueue<Integer> frontier = new PriorityQueue<>((i, j) -> compare(queue.get(i), queue.get(j)), arity);
+        if (k > 0) {
+            frontier.push(0);
+        }
+        for (int i = 0; i < k; i++) {
+            int index = frontier.top();
+            frontier.pop();
+            taken[index] = true;
+            E e = queue.get(index);
+            popped.add(e);
+            hashMap.remove(e);
+            int firstChild = arity * index + 1;
+            int lastChild = Math.min(firstChild + arity, size);
+            for (int child = firstChild; child < lastChild; child++) {
+                frontier.push(child); // The children of a popped element are the next candidates
+            }
+        }
+
+        int kept = 0;
+        for (int index = 0; index < size; index++) {
+            if (!taken[index]) {
+                E e = queue.get(index);
+                queue.set(kept, e);
+                hashMap.put(e, kept);
+                kept++;
+            }
+        }
+        queue.subList(kept, size).clear();
+        heapify();
+        return popped;
+    }
+
     /**
      * Checks if the queue contains a specific element.
      *
@@ -91,11 +263,11 @@ public class PriorityQueue<E> implements AbstractQueue<E> {
         if (empty()) {
             throw new IllegalStateException("Queue is empty.");
         }
-        int last = queue.size() - 1;
-        swap(0, last);
-        hashMap.remove(queue.get(last));
-        queue.remove(last);
-        fixQueue(0);
+        hashMap.remove(queue.get(0));
+        E last = queue.remove(queue.size() - 1);
+        if (!queue.isEmpty()) {
+            siftDown(0, last); // The last element fills the hole left at the top
+        }
     }
 
     /**
@@ -106,78 +278,163 @@ public class PriorityQueue<E> implements AbstractQueue<E> {
      */
     @Override
     public boolean remove(E e) {
-        Integer index = hashMap.get(e);
-        int last = queue.size() - 1;
+        Integer index = hashMap.remove(e);
         if (index == null) {
             return false;
         } else {
-            if (index != last) {
-                swap(index, last);
-                queue.remove(last); // Remove the last element
-                hashMap.remove(e);  // Remove it from the map
-                fixQueue(index);
-            } else {
-                queue.remove(last); // If it's the last element we remove it
-                hashMap.remove(e);  // Remove it from the map
+            E last = queue.remove(queue.size() - 1);
+            if (index < queue.size()) {
+                fixHole(index, last); // The last element fills the hole left by e
             }
             return true;
         }
     }
 
     /**
-     * Reorders the queue to maintain heap properties after an element has been added or removed.
+     * Restores the order of the queue after the priority of an element in it has changed,
+     * sifting it in place from the position stored in the hash map.
      *
-     * @param index the index of the element to be reordered
+     * @param e the element whose priority has changed
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
      */
-    private void fixQueue(int index) {
-        // Move the new element up to the correct position
-        int parent = (index - 1) / 2;
+    @Override
+    public boolean updatePriority(E e) {
+        Integer index = hashMap.get(e);
+        if (index == null) {
+            return false;
+        }
+        fixHole(index, e);
+        return true;
+    }
 
-        while (index > 0 && compare(queue.get(index), queue.get(parent)) < 0) {
-            swap(index, parent); // Swap if the element is smaller than its parent
-            index = parent;
-            parent = (index - 1) / 2; // Update the parent index
+    /**
+     * Restores the order of the queue after the priority of an element in it has decreased,
+     * sifting it up only.
+     *
+     * @param e the element whose priority has decreased
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    @Override
+    public boolean decreasePriority(E e) {
+        Integer index = hashMap.get(e);
+        if (index == null) {
+            return false;
         }
+        siftUp(index, e);
+        return true;
+    }
 
-        // Move a displaced element down to the correct position
-        int size = queue.size();
-        boolean loop = true;
+    /**
+     * Removes the element at the top of the queue and adds an element not in the queue, with a
+     * single sift-down instead of the two sifts of {@code pop} and {@code push}.
+     *
+     * @param e the element to be added, which must not be in the queue
+     * @throws IllegalStateException if the queue is empty
+     */
+    void replaceTop(E e) {
+        hashMap.remove(top());
+        siftDown(0, e);
+    }
 
-        while (index < size && loop) {
-            int leftChild = 2 * index + 1;
-            int rightChild = 2 * index + 2;
-            int smallestChild = index;
+    /**
+     * Returns the elements of the queue, in heap order.
+     *
+     * @return an unmodifiable view of the elements
+     */
+    List<E> elements() {
+        return Collections.unmodifiableList(queue);
+    }
 
-            if (leftChild < size && compare(queue.get(leftChild), queue.get(smallestChild)) < 0) {
-                smallestChild = leftChild;
+    /**
+     * Rebuilds the heap bottom-up with Floyd's method, sifting down every element that has
+     * children, from the last one to the root, in {@code O(N)} time.
+     */
+    private void heapify() {
+        int size = queue.size();
+        if (size > 1) {
+            for (int index = (size - 2) / arity; index >= 0; index--) {
+                siftDown(index, queue.get(index));
             }
+        }
+    }
 
-            if (rightChild < size && compare(queue.get(rightChild), queue.get(smallestChild)) < 0) {
-                smallestChild = rightChild;
-            }
+    /**
+     * Places an element into a hole of the heap, moving it up or down from there.
+     *
+     * @param index the index of the hole
+     * @param e the element to be placed
+     */
+    private void fixHole(int index, E e) {
+        if (index > 0 && compare(e, queue.get((index - 1) / arity)) < 0) {
+            siftUp(index, e);
+        } else {
+            siftDown(index, e);
+        }
+    }
 
-            if (smallestChild == index) {
-                loop = false; // Stop if the element is in the correct position
+    /**
+     * Places an element into a hole of the heap, moving the hole up until the element is not
+     * smaller than the parent of the hole. Each parent moved down into the hole is written to
+     * the queue and to the hash map once, and so is the element at its final index; nothing is
+     * swapped.
+     *
+     * @param index the index of the hole
+     * @param e the element to be placed
+     * @return the index the element ends up at
+     */
+    private int siftUp(int index, E e) {
+        while (index > 0) {
+            int parent = (index - 1) / arity;
+            E parentElement = queue.get(parent);
+            if (compare(e, parentElement) >= 0) {
+                break;
             }
-
-            swap(index, smallestChild); // Swap and continue downward
-            index = smallestChild;
+            queue.set(index, parentElement); // The parent moves down into the hole
+            hashMap.put(parentElement, index);
+            index = parent;
         }
+        queue.set(index, e);
+        hashMap.put(e, index);
+        return index;
     }
 
     /**
-     * Swaps two elements in the queue and updates their indices in the hash map.
+     * Places an element into a hole of the heap, moving the hole down until no child of the
+     * hole is smaller than the element. As in {@link #siftUp}, each element moved is written once.
      *
-     * @param i the index of the first element
-     * @param j the index of the second element
+     * @param index the index of the hole
+     * @param e the element to be placed
      */
-    private void swap(int i, int j) {
-        E temp_i = queue.get(i);
-        E temp_j = queue.get(j);
-        queue.set(i, temp_j);
-        queue.set(j, temp_i);
-        hashMap.put(temp_j, i);
-        hashMap.put(temp_i, j);
+    private void siftDown(int index, E e) {
+        int size = queue.size();
+
+        while (true) {
+            int firstChild = arity * index + 1;
+            if (firstChild >= size) {
+                break; // The hole is a leaf
+            }
+            int lastChild = Math.min(firstChild + arity, size); // Children are contiguous
+            int smallestChild = firstChild;
+            E smallest = queue.get(firstChild);
+
+            for (int child = firstChild + 1; child < lastChild; child++) {
+                E candidate = queue.get(child);
+                if (compare(candidate, smallest) < 0) {
+                    smallestChild = child;
+                    smallest = candidate;
+                }
+            }
+
+            if (compare(smallest, e) >= 0) {
+                break; // Stop if the element fits in the hole
+            }
+
+            queue.set(index, smallest); // The smallest child moves up into the hole
+            hashMap.put(smallest, index);
+            index = smallestChild;
+        }
+        queue.set(index, e);
+        hashMap.put(e, index);
     }
 
     /**
@@ -2,9 +2,16 @@ package priorityqueue;
 
 import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNull;
 import static org.junit.Assert.assertTrue;
 
+import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.Comparator;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.concurrent.atomic.AtomicIntegerArray;
 import org.junit.Before;
 import org.junit.Test;
 
@@ -232,4 +239,418 @@ public class PriorityQueueTests {
         assertTrue(PriorityQueueStr.remove(str1));
         assertTrue(PriorityQueueStr.empty());
     }
+
+    /**
+     * Tests moving elements up and down after their priority has changed.
+     */
+    @Test
+    public void testUpdatePriority() {
+        Map<String, Integer> priorities = new HashMap<>();
+        PriorityQueue<String> queue = new PriorityQueue<>(Comparator.comparingInt(priorities::get));
+        priorities.put(str1, 3);
+        priorities.put(str2, 2);
+        priorities.put(str3, 1);
+        queue.push(str1);
+        queue.push(str2);
+        queue.push(str3);
+        assertEquals(str3, queue.top());
+
+        priorities.put(str1, 0);
+        assertTrue(queue.updatePriority(str1));
+        assertEquals(str1, queue.top());
+
+        priorities.put(str1, 4);
+        assertTrue(queue.updatePriority(str1));
+        assertEquals(str3, queue.top());
+        queue.pop();
+        assertEquals(str2, queue.top());
+        queue.pop();
+        assertEquals(str1, queue.top());
+    }
+
+    /**
+     * Tests that the priority of an element not in the queue cannot be updated.
+     */
+    @Test
+    public void testUpdatePriorityMissing() {
+        PriorityQueueInt.push(int1);
+        assertFalse(PriorityQueueInt.updatePriority(int2));
+    }
+
+    /**
+     * Tests that heaps of larger arity return the elements in order.
+     */
+    @Test
+    public void testArityOrder() {
+        for (int arity : new int[] {3, 4, 8}) {
+            PriorityQueue<Integer> queue = new PriorityQueue<>(new IntegerComparator(), arity);
+            assertEquals(arity, queue.getArity());
+            for (int i = 0; i < 100; i++) {
+                queue.push((i * 37) % 100);
+            }
+            queue.remove(50);
+            for (int i = 0; i < 100; i++) {
+                if (i != 50) {
+                    assertEquals(Integer.valueOf(i), queue.top());
+                    queue.pop();
+                }
+            }
+            assertTrue(queue.empty());
+        }
+    }
+
+    /**
+     * Tests that a heap cannot have fewer than two children per node.
+     */
+    @Test(expected = IllegalArgumentException.class)
+    public void testArityTooSmall() {
+        new PriorityQueue<>(new IntegerComparator(), 1);
+    }
+
+    /**
+     * Tests building a queue from a collection, which may repeat elements.
+     */
+    @Test
+    public void testConstructFromCollection() {
+        List<Integer> elements = new ArrayList<>();
+        for (int i = 0; i < 50; i++) {
+            elements.add((i * 13) % 50);
+            elements.add((i * 7) % 50);
+        }
+        for (int arity : new int[] {2, 4}) {
+            PriorityQueue<Integer> queue = new PriorityQueue<>(elements, new IntegerComparator(), arity);
+            assertTrue(queue.contains(49));
+            for (int i = 0; i < 50; i++) {
+                assertEquals(Integer.valueOf(i), queue.top());
+                queue.pop();
+            }
+            assertTrue(queue.empty());
+        }
+    }
+
+    /**
+     * Tests adding a collection to a queue, both larger and smaller than its contents.
+     */
+    @Test
+    public void testPushAll() {
+        PriorityQueueDoub.push(doub1);
+        assertTrue(PriorityQueueDoub.pushAll(Arrays.asList(doub2, doub3, doub1)));
+        assertFalse(PriorityQueueDoub.pushAll(Arrays.asList(doub2)));
+        assertTrue(PriorityQueueDoub.pushAll(Arrays.asList(-1000.0)));
+        assertTrue(PriorityQueueDoub.remove(doub3));
+        assertEquals(Double.valueOf(-1000.0), PriorityQueueDoub.top());
+        PriorityQueueDoub.pop();
+        assertEquals(doub2, PriorityQueueDoub.top());
+        PriorityQueueDoub.pop();
+        assertEquals(doub1, PriorityQueueDoub.top());
+        PriorityQueueDoub.pop();
+        assertTrue(PriorityQueueDoub.empty());
+    }
+
+    /**
+     * Tests that the {@link PairingHeap} returns the elements in order, after removals and priority changes.
+     */
+    @Test
+    public void testPairingHeap() {
+        Map<Integer, Integer> priorities = new HashMap<>();
+        PairingHeap<Integer> heap = new PairingHeap<>(Comparator.comparingInt(priorities::get));
+        for (int i = 0; i < 100; i++) {
+            priorities.put(i, (i * 37) % 100);
+            assertTrue(heap.push(i));
+        }
+        assertFalse(heap.push(10));
+        assertTrue(heap.remove(1)); // Priority 37
+        assertFalse(heap.remove(1));
+
+        priorities.put(99, -1); // From 63
+        assertTrue(heap.decreasePriority(99));
+        PairingHeap.Handle<Integer> handle = heap.handle(98); // Priority 26
+        priorities.put(98, -2);
+        heap.decreaseKey(handle);
+        priorities.put(0, 1000); // From 0
+        assertTrue(heap.updatePriority(0));
+
+        assertEquals(99, heap.size());
+        int previous = Integer.MIN_VALUE;
+        while (!heap.empty()) {
+            int priority = priorities.get(heap.top());
+            assertTrue(previous <= priority);
+            previous = priority;
+            heap.pop();
+        }
+        assertEquals(1000, previous);
+    }
+
+    /**
+     * Tests that the top of an empty {@link PairingHeap} cannot be retrieved.
+     */
+    @Test(expected = IllegalStateException.class)
+    public void testPairingHeapTopEmpty() {
+        new PairingHeap<>(new IntegerComparator()).top();
+    }
+
+    /**
+     * Tests that the {@link RadixHeap} returns the elements in order of their monotone keys.
+     */
+    @Test
+    public void testRadixHeap() {
+        Map<String, Long> keys = new HashMap<>();
+        RadixHeap<String> heap = new RadixHeap<>(keys::get);
+        keys.put(str1, 7L);
+        keys.put(str2, 3L);
+        keys.put(str3, 1L << 40);
+        heap.push(str1);
+        heap.push(str2);
+        heap.push(str3);
+        assertEquals(str2, heap.top());
+        heap.pop();
+
+        keys.put("Topo", 3L); // Not below the last key popped
+        heap.push("Topo");
+        keys.put(str3, 5L);
+        assertTrue(heap.updatePriority(str3));
+        assertTrue(heap.remove(str1));
+        assertEquals("Topo", heap.top());
+        heap.pop();
+        assertEquals(str3, heap.top());
+        heap.pop();
+        assertTrue(heap.empty());
+    }
+
+    /**
+     * Tests that the {@link RadixHeap} rejects a key smaller than the last key popped.
+     */
+    @Test(expected = IllegalArgumentException.class)
+    public void testRadixHeapNotMonotone() {
+        Map<Integer, Long> keys = new HashMap<>();
+        RadixHeap<Integer> heap = new RadixHeap<>(keys::get);
+        keys.put(int1, 10L);
+        heap.push(int1);
+        heap.pop();
+        keys.put(int2, 9L);
+        heap.push(int2);
+    }
+
+    /**
+     * Tests that the {@link ConcurrentRelaxedPriorityQueue} behaves as an exact queue when it has a single heap.
+     */
+    @Test
+    public void testConcurrentSingleHeap() {
+        ConcurrentRelaxedPriorityQueue<Integer> queue = new ConcurrentRelaxedPriorityQueue<>(new IntegerComparator(), 1, 1);
+        queue.push(int3);
+        queue.push(int1);
+        queue.push(int2);
+        assertFalse(queue.push(int1));
+        assertTrue(queue.contains(int2));
+        assertEquals(int1, queue.top());
+        assertTrue(queue.remove(int2));
+        assertEquals(int1, queue.poll());
+        queue.pop();
+        assertTrue(queue.empty());
+        assertNull(queue.poll());
+    }
+
+    /**
+     * Tests that every element pushed into a {@link ConcurrentRelaxedPriorityQueue} by several
+     * threads is polled exactly once by several threads.
+     */
+    @Test
+    public void testConcurrentPushPoll() throws InterruptedException {
+        int threads = 4;
+        int perThread = 10000;
+        ConcurrentRelaxedPriorityQueue<Integer> queue = new ConcurrentRelaxedPriorityQueue<>(new IntegerComparator(), threads);
+        Thread[] workers = new Thread[threads];
+        for (int t = 0; t < threads; t++) {
+            int first = t * perThread;
+            workers[t] = new Thread(() -> {
+                for (int i = first; i < first + perThread; i++) {
+                    queue.push(i);
+                }
+            });
+            workers[t].start();
+        }
+        for (Thread worker : workers) {
+            worker.join();
+        }
+        assertEquals(threads * perThread, queue.size());
+
+        AtomicIntegerArray seen = new AtomicIntegerArray(threads * perThread);
+        for (int t = 0; t < threads; t++) {
+            workers[t] = new Thread(() -> {
+                Integer e;
+                while ((e = queue.poll()) != null) {
+                    seen.incrementAndGet(e);
+                }
+            });
+            workers[t].start();
+        }
+        for (Thread worker : workers) {
+            worker.join();
+        }
+        assertTrue(queue.empty());
+        for (int i = 0; i < threads * perThread; i++) {
+            assertEquals(1, seen.get(i));
+        }
+    }
+
+    /**
+     * Tests removing the smallest elements in a batch, popping them one by one for a small
+     * batch and rebuilding the heap for a large one.
+     */
+    @Test
+    public void testPopK() {
+        for (int arity : new int[] {2, 4}) {
+            for (int k : new int[] {3, 60}) {
+                PriorityQueue<Integer> queue = new PriorityQueue<>(new IntegerComparator(), arity);
+                for (int i = 0; i < 100; i++) {
+                    queue.push((i * 37) % 100);
+                }
+                List<Integer> popped = queue.popK(k);
+                assertEquals(k, popped.size());
+                for (int i = 0; i < k; i++) {
+                    assertEquals(Integer.valueOf(i), popped.get(i));
+                    assertFalse(queue.contains(i));
+                }
+                assertEquals(100 - k, queue.size());
+                assertTrue(queue.remove(k + 1));
+                assertEquals(Integer.valueOf(k), queue.top());
+                assertEquals(100 - k - 1, queue.popK(1000).size());
+                assertTrue(queue.empty());
+            }
+        }
+    }
+
+    /**
+     * Tests that a negative number of elements cannot be popped.
+     */
+    @Test(expected = IllegalArgumentException.class)
+    public void testPopKNegative() {
+        PriorityQueueInt.popK(-1);
+    }
+
+    /**
+     * Tests that the {@link TopKCollector} keeps the smallest elements of a stream.
+     */
+    @Test
+    public void testTopKCollector() {
+        TopKCollector<Integer> collector = new TopKCollector<>(5, new IntegerComparator());
+        for (int i = 0; i < 1000; i++) {
+            collector.offer((i * 37) % 1000);
+        }
+        assertEquals(5, collector.size());
+        assertEquals(Integer.valueOf(4), collector.largest());
+        assertEquals(Arrays.asList(0, 1, 2, 3, 4), collector.toSortedList());
+        assertFalse(collector.offer(2));
+        assertTrue(collector.offer(-1));
+        assertEquals(Arrays.asList(-1, 0, 1, 2, 3), collector.toSortedList());
+
+        TopKCollector<String> none = new TopKCollector<>(0, new StringComparator());
+        Arrays.asList(str1, str2, str3).forEach(none);
+        assertEquals(0, none.size());
+    }
+
+    /**
+     * Tests that the {@link IndexedDoublePriorityQueue} returns its ids by increasing key.
+     */
+    @Test
+    public void testIndexedPopOrder() {
+        IndexedDoublePriorityQueue queue = new IndexedDoublePriorityQueue(5);
+        queue.push(3, 34.55);
+        queue.push(0, -454.91);
+        queue.push(4, 1.6);
+        queue.push(1, 0.0);
+        assertEquals(4, queue.size());
+        assertEquals(0, queue.top());
+        assertEquals(-454.91, queue.topKey(), 0.0);
+        queue.pop();
+        assertEquals(1, queue.top());
+        queue.pop();
+        assertEquals(4, queue.top());
+        queue.pop();
+        assertEquals(3, queue.top());
+        queue.pop();
+        assertTrue(queue.empty());
+    }
+
+    /**
+     * Tests that an id already in the {@link IndexedDoublePriorityQueue} is not pushed again.
+     */
+    @Test
+    public void testIndexedPushDuplicate() {
+        IndexedDoublePriorityQueue queue = new IndexedDoublePriorityQueue(3);
+        assertTrue(queue.push(2, 1.0));
+        assertFalse(queue.push(2, 0.5));
+        assertEquals(1, queue.size());
+        assertEquals(1.0, queue.getKey(2), 0.0);
+    }
+
+    /**
+     * Tests the constant time membership test of the {@link IndexedDoublePriorityQueue}.
+     */
+    @Test
+    public void testIndexedContains() {
+        IndexedDoublePriorityQueue queue = new IndexedDoublePriorityQueue(3);
+        queue.push(1, 2.0);
+        assertTrue(queue.contains(1));
+        assertFalse(queue.contains(0));
+        assertFalse(queue.contains(-1));
+        assertFalse(queue.contains(3));
+        queue.pop();
+        assertFalse(queue.contains(1));
+    }
+
+    /**
+     * Tests removing an id from the middle of the {@link IndexedDoublePriorityQueue}.
+     */
+    @Test
+    public void testIndexedRemove() {
+        IndexedDoublePriorityQueue queue = new IndexedDoublePriorityQueue(6);
+        for (int id = 0; id < 6; id++) {
+            queue.push(id, 10.0 - id);
+        }
+        assertTrue(queue.remove(2));
+        assertFalse(queue.remove(2));
+        int[] expected = {5, 4, 3, 1, 0};
+        for (int id : expected) {
+            assertEquals(id, queue.top());
+            queue.pop();
+        }
+        assertTrue(queue.empty());
+    }
+
+    /**
+     * Tests changing the key of an id in the {@link IndexedDoublePriorityQueue} in both directions.
+     */
+    @Test
+    public void testIndexedUpdateKey() {
+        IndexedDoublePriorityQueue queue = new IndexedDoublePriorityQueue(4);
+        for (int id = 0; id < 4; id++) {
+            queue.push(id, id);
+        }
+        assertTrue(queue.updateKey(3, -1.0));
+        assertEquals(3, queue.top());
+        assertTrue(queue.updateKey(3, 5.0));
+        assertEquals(0, queue.top());
+        queue.pop();
+        queue.pop();
+        queue.pop();
+        assertEquals(3, queue.top());
+        assertEquals(5.0, queue.topKey(), 0.0);
+    }
+
+    /**
+     * Tests that an id out of range cannot be pushed in the {@link IndexedDoublePriorityQueue}.
+     */
+    @Test(expected = IllegalArgumentException.class)
+    public void testIndexedPushOutOfRange() {
+        new IndexedDoublePriorityQueue(2).push(2, 1.0);
+    }
+
+    /**
+     * Tests that the top of an empty {@link IndexedDoublePriorityQueue} cannot be retrieved.
+     */
+    @Test(expected = IllegalStateException.class)
+    public void testIndexedTopEmpty() {
+        new IndexedDoublePriorityQueue(2).top();
+    }
 }
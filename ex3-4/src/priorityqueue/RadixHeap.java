@@ -0,0 +1,240 @@
+package priorityqueue;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.function.ToLongFunction;
+
+/**
+ * A monotone priority queue implementation using a radix heap.
+ * <p>
+ * Priorities are non-negative {@code long} keys, and no key may be smaller than the last key
+ * at the top of the queue, as happens with the distances popped by Dijkstra's algorithm on
+ * integer lengths. An element is kept in the bucket of the highest bit in which its key differs
+ * from that last key, so there are 65 buckets and bucket 0 holds the elements with the last
+ * key. When bucket 0 is empty, the first non-empty bucket is redistributed around its smallest
+ * key; an element only ever moves to lower buckets, so all the operations cost {@code O(1)}
+ * amortized plus {@code O(64)} per element over its lifetime.
+ * <p>
+ * The key of an element is read through a function when it is pushed and when its priority is
+ * updated, and kept until the next update.
+ *
+ * @param <E> the type of elements in the queue
+ */
+public class RadixHeap<E> implements AbstractQueue<E> {
+
+    /**
+     * An element with its key and its place in the buckets.
+     *
+     * @param <E> the type of the element
+     */
+    private static final class Entry<E> {
+        private final E element;
+        private long key;
+        private int bucket;
+        private int index; // Position in the list of its bucket
+
+        private Entry(E element, long key) {
+            this.element = element;
+            this.key = key;
+        }
+    }
+
+    private final ArrayList<ArrayList<Entry<E>>> buckets;
+    private HashMap<E, Entry<E>> entries;
+    private ToLongFunction<E> keyFunction;
+    private long last; // Key at the top of the queue, a lower bound for every key
+
+    /**
+     * Constructs a new {@code RadixHeap} with the specified key function.
+     *
+     * @param keyFunction the function giving the key of an element; smaller keys come first
+     */
+    public RadixHeap(ToLongFunction<E> keyFunction) {
+        this.buckets = new ArrayList<>(Long.SIZE + 1);
+        for (int i = 0; i <= Long.SIZE; i++) {
+            buckets.add(new ArrayList<>());
+        }
+        this.entries = new HashMap<>();
+        this.keyFunction = keyFunction;
+        this.last = 0;
+    }
+
+    /**
+     * Checks if the queue is empty.
+     *
+     * @return {@code true} if the queue is empty, {@code false} otherwise
+     */
+    @Override
+    public boolean empty() {
+        return entries.isEmpty();
+    }
+
+    /**
+     * Returns the number of elements in the queue.
+     *
+     * @return the size of the queue
+     */
+    public int size() {
+        return entries.size();
+    }
+
+    /**
+     * Adds an element to the queue. If the element is already in the queue, it is not added again.
+     *
+     * @param e the element to be added
+     * @return {@code true} if the element was added successfully, {@code false} otherwise
+     * @throws IllegalArgumentException if the key of the element is smaller than the key at the top of the queue
+     */
+    @Override
+    public boolean push(E e) {
+        if (contains(e)) {
+            return false;
+        }
+        Entry<E> entry = new Entry<>(e, checkKey(keyFunction.applyAsLong(e)));
+        entries.put(e, entry);
+        insert(entry);
+        return true;
+    }
+
+    /**
+     * Checks if the queue contains a specific element.
+     *
+     * @param e the element to check
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     */
+    @Override
+    public boolean contains(E e) {
+        return entries.containsKey(e);
+    }
+
+    /**
+     * Retrieves the element at the top of the queue without removing it.
+     *
+     * @return the element at the top of the queue
+     * @throws IllegalStateException if the queue is empty
+     */
+    @Override
+    public E top() {
+        ArrayList<Entry<E>> first = firstBucket();
+        return first.get(first.size() - 1).element;
+    }
+
+    /**
+     * Removes the element at the top of the queue.
+     *
+     * @throws IllegalStateException if the queue is empty
+     */
+    @Override
+    public void pop() {
+        ArrayList<Entry<E>> first = firstBucket();
+        Entry<E> entry = first.remove(first.size() - 1);
+        entries.remove(entry.element);
+    }
+
+    /**
+     * Removes a specific element from the queue if it is present.
+     *
+     * @param e the element to be removed
+     * @return {@code true} if the element was removed successfully, {@code false} otherwise
+     */
+    @Override
+    public boolean remove(E e) {
+        Entry<E> entry = entries.remove(e);
+        if (entry == null) {
+            return false;
+        }
+        detach(entry);
+        return true;
+    }
+
+    /**
+     * Reads again the key of an element in the queue and moves it to its new bucket.
+     *
+     * @param e the element whose priority has changed
+     * @return {@code true} if the element is in the queue, {@code false} otherwise
+     * @throws IllegalArgumentException if the new key is smaller than the key at the top of the queue
+     */
+    @Override
+    public boolean updatePriority(E e) {
+        Entry<E> entry = entries.get(e);
+        if (entry == null) {
+            return false;
+        }
+        long key = checkKey(keyFunction.applyAsLong(e));
+        detach(entry);
+        entry.key = key;
+        insert(entry);
+        return true;
+    }
+
+    /**
+     * Returns bucket 0 after refilling it from the first non-empty bucket if needed.
+     *
+     * @return the bucket of the elements with the smallest key
+     * @throws IllegalStateException if the queue is empty
+     */
+    private ArrayList<Entry<E>> firstBucket() {
+        if (empty()) {
+            throw new IllegalStateException("Queue is empty.");
+        }
+        ArrayList<Entry<E>> first = buckets.get(0);
+        if (first.isEmpty()) {
+            int i = 1;
+            while (buckets.get(i).isEmpty()) {
+                i++;
+            }
+            ArrayList<Entry<E>> bucket = buckets.get(i);
+            long min = Long.MAX_VALUE;
+            for (Entry<E> entry : bucket) {
+                min = Math.min(min, entry.key);
+            }
+            last = min;
+            for (Entry<E> entry : bucket) {
+                insert(entry); // Always into a lower bucket
+            }
+            bucket.clear();
+        }
+        return first;
+    }
+
+    /**
+     * Appends an entry to the bucket of its key.
+     *
+     * @param entry the entry to be placed
+     */
+    private void insert(Entry<E> entry) {
+        int bucket = Long.SIZE - Long.numberOfLeadingZeros(entry.key ^ last);
+        ArrayList<Entry<E>> list = buckets.get(bucket);
+        entry.bucket = bucket;
+        entry.index = list.size();
+        list.add(entry);
+    }
+
+    /**
+     * Takes an entry out of its bucket, moving the last entry of the bucket into its place.
+     *
+     * @param entry the entry to be taken out
+     */
+    private void detach(Entry<E> entry) {
+        ArrayList<Entry<E>> list = buckets.get(entry.bucket);
+        Entry<E> moved = list.remove(list.size() - 1);
+        if (moved != entry) {
+            moved.index = entry.index;
+            list.set(entry.index, moved);
+        }
+    }
+
+    /**
+     * Checks that a key can enter the queue.
+     *
+     * @param key the key to check
+     * @return the key
+     * @throws IllegalArgumentException if the key is smaller than the key at the top of the queue
+     */
+    private long checkKey(long key) {
+        if (key < last) {
+            throw new IllegalArgumentException("Key " + key + " is smaller than the last key at the top, " + last + ".");
+        }
+        return key;
+    }
+}
@@ -0,0 +1,97 @@
+package priorityqueue;
+
+import java.util.ArrayList;
+import java.util.Comparator;
+import java.util.List;
+import java.util.function.Consumer;
+
+/**
+ * Collects the {@code k} smallest elements of a stream in {@code O(k)} memory.
+ * <p>
+ * The elements kept are held in a {@link PriorityQueue} of at most {@code k} elements with the
+ * reversed comparator, so its top is the largest of them: an element offered is compared with
+ * it only, and when it is smaller it replaces it with a single sift-down. Offering {@code N}
+ * elements costs {@code O(N log k)} time at most. As in the queues, an element equal to one
+ * already kept is not kept twice.
+ *
+ * @param <E> the type of elements collected
+ */
+public class TopKCollector<E> implements Consumer<E> {
+    private final int k;
+    private final PriorityQueue<E> heap;
+    private final Comparator<E> comparator;
+
+    /**
+     * Constructs an empty {@code TopKCollector}.
+     *
+     * @param k the number of elements to be kept
+     * @param comparator the comparator to determine the order of elements; the smallest are kept
+     * @throws IllegalArgumentException if {@code k} is negative
+     */
+    public TopKCollector(int k, Comparator<E> comparator) {
+        if (k < 0) {
+            throw new IllegalArgumentException("k cannot be negative.");
+        }
+        this.k = k;
+        this.heap = new PriorityQueue<>(comparator.reversed());
+        this.comparator = comparator;
+    }
+
+    /**
+     * Offers an element, keeping it if it is among the {@code k} smallest offered so far.
+     *
+     * @param e the element offered
+     * @return {@code true} if the element is kept, {@code false} otherwise
+     */
+    public boolean offer(E e) {
+        if (heap.size() < k) {
+            return heap.push(e);
+        }
+        if (k == 0 || comparator.compare(e, heap.top()) >= 0 || heap.contains(e)) {
+            return false;
+        }
+        heap.replaceTop(e); // The largest kept element leaves
+        return true;
+    }
+
+    /**
+     * Offers an element, so that the collector can be passed to {@code forEach}.
+     *
+     * @param e the element offered
+     */
+    @Override
+    public void accept(E e) {
+        offer(e);
+    }
+
+    /**
+     * Returns the number of elements kept.
+     *
+     * @return the number of elements kept, at most {@code k}
+     */
+    public int size() {
+        return heap.size();
+    }
+
+    /**
+     * Retrieves the largest element kept, which an element must be smaller than to be kept
+     * once {@code k} elements are.
+     *
+     * @return the largest element kept
+     * @throws IllegalStateException if no element is kept
+     */
+    public E largest() {
+        return heap.top();
+    }
+
+    /**
+     * Returns the elements kept, smallest first, leaving the collector unchanged.
+     *
+     * @return a new list of the elements kept
+     */
+    public List<E> toSortedList() {
+        List<E> sorted = new ArrayList<>(heap.elements());
+        sorted.sort(comparator);
+        return sorted;
+    }
+}